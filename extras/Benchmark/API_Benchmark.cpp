@@ -0,0 +1,332 @@
+///
+/// @file API_Benchmark.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host benchmark of the public methods : encoded bytes, CPU time per call and modeled wire time.
+/// @details The library writes to a capturing transport, which answers the requests (sendme, addt) immediately, so that only the encoding cost is measured. Build and run from the repository root :
+///     g++ -std=gnu++11 -O2 -Iextras/Host -Isrc src/*.cpp extras/Host/Host.cpp extras/Benchmark/API_Benchmark.cpp -o API_Benchmark -lpthread && ./API_Benchmark [--json]
+/// The output is CSV (or JSON Lines with --json), one line per method, in a stable order so that runs can be compared.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Library.hpp"
+
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+static const uint32_t Iterations = 2000;
+
+static const uint32_t Baud_Rates[] = {115200, 921600};
+
+///
+/// @brief Transport counting the written bytes, and answering the requests that would block the caller.
+///
+class Capture_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Capture_Transport_Class() : Written_Bytes(0),
+                                Page_ID(0),
+                                Transparent_Remaining(0)
+    {
+    }
+
+    size_t Write(const uint8_t *Data, size_t Size)
+    {
+        Written_Bytes += Size;
+
+        if (Transparent_Remaining != 0) // -- addt data.
+        {
+            Transparent_Remaining -= (Size < Transparent_Remaining) ? Size : Transparent_Remaining;
+            if (Transparent_Remaining == 0)
+            {
+                Answer(0xFD);
+            }
+            return Size;
+        }
+
+        if (Size < 3 || memcmp(Data + Size - 3, "\xFF\xFF\xFF", 3) != 0)
+        {
+            return Size;
+        }
+        if (Size >= 9 && memcmp(Data, "sendme", 6) == 0)
+        {
+            Answer(0x66, Page_ID);
+        }
+        else if (Size > 5 && memcmp(Data, "page ", 5) == 0)
+        {
+            Page_ID = atoi((const char *)Data + 5);
+        }
+        else if (Size > 5 && memcmp(Data, "addt ", 5) == 0)
+        {
+            size_t Quantity = Size - 3; // -- The quantity is the last argument.
+            while (Data[Quantity - 1] != ',')
+            {
+                Quantity--;
+            }
+            Transparent_Remaining = strtoul(std::string((const char *)Data + Quantity, Size - 3 - Quantity).c_str(), NULL, 10);
+            Answer(0xFE);
+        }
+        return Size;
+    }
+
+    size_t Available()
+    {
+        return Answers.size();
+    }
+
+    size_t Read(uint8_t *Data, size_t Size)
+    {
+        size_t Read = 0;
+        while (Read < Size && !Answers.empty())
+        {
+            Data[Read++] = Answers.front();
+            Answers.pop_front();
+        }
+        return Read;
+    }
+
+    bool Set_Baud_Rate(uint32_t Baud_Rate)
+    {
+        return true;
+    }
+
+    bool Wait_For_Data(uint32_t Time_Out)
+    {
+        return !Answers.empty();
+    }
+
+    void Flush()
+    {
+    }
+
+    uint64_t Written_Bytes;
+
+protected:
+    void Answer(uint8_t Code)
+    {
+        uint8_t Frame[] = {Code, 0xFF, 0xFF, 0xFF};
+        Answers.insert(Answers.end(), Frame, Frame + sizeof(Frame));
+    }
+
+    void Answer(uint8_t Code, uint8_t Value)
+    {
+        uint8_t Frame[] = {Code, Value, 0xFF, 0xFF, 0xFF};
+        Answers.insert(Answers.end(), Frame, Frame + sizeof(Frame));
+    }
+
+    std::deque<uint8_t> Answers;
+    uint8_t Page_ID;
+    uint32_t Transparent_Remaining;
+};
+
+static Capture_Transport_Class Transport;
+static Nextion_Class Display;
+
+static uint8_t Samples[256];
+static int16_t Samples_16[4096];
+static float Samples_Float[4096];
+#if Nextion_String_Overloads
+static const String Object_Name_String("t0");
+static const String Text_String("Hello world");
+#endif
+
+static constexpr Nextion_Number_Class Number = Nextion_Number("n0");
+static constexpr Nextion_Progress_Bar_Class Progress_Bar = Nextion_Progress_Bar("j0");
+static constexpr Nextion_Text_Class Text = Nextion_Text("t0");
+static constexpr Nextion_Picture_Class Picture = Nextion_Picture("p0");
+static constexpr Nextion_Waveform_Class Waveform = Nextion_Waveform("s0", 1, 0);
+
+typedef struct
+{
+    const char *Name;
+    void (*Function)(uint32_t Iteration);
+} Benchmark_Type;
+
+// -- Every public method encoding an instruction, called with typical arguments.
+static const Benchmark_Type Benchmarks[] = {
+    {"Draw_Pixel", [](uint32_t i) { Display.Draw_Pixel(120, 80, 0xF800); }},
+    {"Draw_Rectangle", [](uint32_t i) { Display.Draw_Rectangle(10, 20, 200, 100, 0x07E0); }},
+    {"Draw_Circle", [](uint32_t i) { Display.Draw_Circle(240, 160, 50, 0x001F); }},
+    {"Draw_Fill", [](uint32_t i) { Display.Draw_Fill(10, 20, 200, 100, 0xFFFF); }},
+    {"Draw_Line", [](uint32_t i) { Display.Draw_Line(0, 0, 479, 319, 0xFFFF); }},
+    {"Draw_Picture", [](uint32_t i) { Display.Draw_Picture(0, 0, 3); }},
+    {"Draw_Crop_Picture", [](uint32_t i) { Display.Draw_Crop_Picture(10, 20, 100, 50, 3); }},
+    {"Draw_Advanced_Crop_Picture", [](uint32_t i) { Display.Draw_Advanced_Crop_Picture(10, 20, 100, 50, 30, 40, 3); }},
+    {"Draw_Text(const char*)", [](uint32_t i) { Display.Draw_Text(10, 20, 200, 30, 0, 0xFFFF, 0x0000, 1, 1, 1, "Hello world"); }},
+#if Nextion_String_Overloads
+    {"Draw_Text(String)", [](uint32_t i) { Display.Draw_Text(10, 20, 200, 30, 0, 0xFFFF, 0x0000, 1, 1, 1, Text_String); }},
+#endif
+    {"Set_Font(F)", [](uint32_t i) { Display.Set_Font(F("t0"), 2); }},
+    {"Set_Font(const char*)", [](uint32_t i) { Display.Set_Font("t0", 2); }},
+    {"Set_Background_Color", [](uint32_t i) { Display.Set_Background_Color(F("t0"), 0xF800); }},
+    {"Set_Font_Color", [](uint32_t i) { Display.Set_Font_Color(F("t0"), 0x07E0); }},
+    {"Set_Horizontal_Alignment", [](uint32_t i) { Display.Set_Horizontal_Alignment(F("t0"), 1); }},
+    {"Set_Vertical_Alignment", [](uint32_t i) { Display.Set_Vertical_Alignment(F("t0"), 1); }},
+    {"Set_Mask", [](uint32_t i) { Display.Set_Mask(F("t0"), true); }},
+    {"Set_Wordwrap", [](uint32_t i) { Display.Set_Wordwrap(F("t0"), true); }},
+    {"Set_Text(F,char)", [](uint32_t i) { Display.Set_Text(F("t0"), 'A'); }},
+    {"Set_Text(F,F)", [](uint32_t i) { Display.Set_Text(F("t0"), F("Hello world")); }},
+#if Nextion_String_Overloads
+    {"Set_Text(String,String)", [](uint32_t i) { Display.Set_Text(Object_Name_String, Text_String); }},
+#endif
+    {"Set_Text(const char*,const char*)", [](uint32_t i) { Display.Set_Text("t0", "Hello world"); }},
+    {"Set_Text(F,const char*)", [](uint32_t i) { Display.Set_Text(F("t0"), "Hello \"world\""); }},
+    {"Set_Text(const char*,const char*,size_t)", [](uint32_t i) { Display.Set_Text("t0", "Hello world", 11); }},
+    {"Set_Text_Format", [](uint32_t i) { Display.Set_Text_Format("t0", "%d.%02d V", 12, (int)(i % 100)); }},
+    {"Add_Text(F,const char*)", [](uint32_t i) { Display.Add_Text(F("t0"), "abc"); }},
+    {"Add_Text(F,char)", [](uint32_t i) { Display.Add_Text(F("t0"), 'a'); }},
+    {"Delete_Text", [](uint32_t i) { Display.Delete_Text(F("t0"), 3); }},
+    {"Set_Maximum_Value", [](uint32_t i) { Display.Set_Maximum_Value(F("h0"), 1000); }},
+    {"Set_Minimum_Value", [](uint32_t i) { Display.Set_Minimum_Value(F("h0"), 10); }},
+    {"Set_Value(F)", [](uint32_t i) { Display.Set_Value(F("n0"), 1234567 + i); }},
+#if Nextion_String_Overloads
+    {"Set_Value(String)", [](uint32_t i) { Display.Set_Value(Object_Name_String, 1234567 + i); }},
+#endif
+    {"Set_Value(const char*)", [](uint32_t i) { Display.Set_Value("n0", 1234567 + i); }},
+    {"Set_Global_Variable", [](uint32_t i) { Display.Set_Global_Variable(F("va0"), 42); }},
+    {"Set_Channel_Color", [](uint32_t i) { Display.Set_Channel_Color(F("s0"), 0, 0xF800); }},
+    {"Set_Grid_Color", [](uint32_t i) { Display.Set_Grid_Color(F("s0"), 0x8410); }},
+    {"Set_Grid_Width", [](uint32_t i) { Display.Set_Grid_Width(F("s0"), 40); }},
+    {"Set_Grid_Height", [](uint32_t i) { Display.Set_Grid_Height(F("s0"), 20); }},
+    {"Set_Data_Scaling", [](uint32_t i) { Display.Set_Data_Scaling(F("s0"), 200); }},
+    {"Set_Picture(F)", [](uint32_t i) { Display.Set_Picture(F("p0"), 3); }},
+#if Nextion_String_Overloads
+    {"Set_Picture(String)", [](uint32_t i) { Display.Set_Picture(Object_Name_String, 3); }},
+#endif
+    {"Set_Time", [](uint32_t i) { Display.Set_Time(F("tm0"), 500); }},
+    {"Set_Trigger(F)", [](uint32_t i) { Display.Set_Trigger(F("tm0"), true); }},
+#if Nextion_String_Overloads
+    {"Set_Trigger(String)", [](uint32_t i) { Display.Set_Trigger(Object_Name_String, true); }},
+#endif
+    {"Set_Reparse_Mode", [](uint32_t i) { Display.Set_Reparse_Mode(0); }},
+    {"Set_Current_Page(uint8_t)", [](uint32_t i) { Display.Set_Current_Page(i & 1); }},
+    {"Set_Current_Page(F)", [](uint32_t i) { Display.Set_Current_Page(F("Main")); }},
+    {"Get_Current_Page", [](uint32_t i) { Display.Get_Current_Page(true); }},
+    {"Set_Brightness", [](uint32_t i) { Display.Set_Brightness(80); }},
+    {"Set_Display_Baud_Rate", [](uint32_t i) { Display.Set_Display_Baud_Rate(115200, false); }},
+    {"Set_Horizontal_Font_Spacing", [](uint32_t i) { Display.Set_Horizontal_Font_Spacing(2); }},
+    {"Set_Vertical_Font_Spacing", [](uint32_t i) { Display.Set_Vertical_Font_Spacing(2); }},
+    {"Set_Draw_Color", [](uint32_t i) { Display.Set_Draw_Color(0xF800); }},
+    {"Set_Drawing", [](uint32_t i) { Display.Set_Drawing(true); }},
+    {"Set_Random_Generator", [](uint32_t i) { Display.Set_Random_Generator(-100, 100); }},
+    {"Set_Standby_Serial_Timer", [](uint32_t i) { Display.Set_Standby_Serial_Timer(60); }},
+    {"Set_Standby_Touch_Timer", [](uint32_t i) { Display.Set_Standby_Touch_Timer(60); }},
+    {"Set_Serial_Wake_Up", [](uint32_t i) { Display.Set_Serial_Wake_Up(true); }},
+    {"Set_Touch_Wake_Up", [](uint32_t i) { Display.Set_Touch_Wake_Up(true); }},
+    {"Set_Wake_Up_Page", [](uint32_t i) { Display.Set_Wake_Up_Page(1); }},
+    {"Sleep", [](uint32_t i) { Display.Sleep(); }},
+    {"Wake_Up", [](uint32_t i) { Display.Wake_Up(); }},
+    {"Set_Debugging", [](uint32_t i) { Display.Set_Debugging(0); }},
+    {"Start_Sending_Realtime_Coordinate", [](uint32_t i) { Display.Start_Sending_Realtime_Coordinate(); }},
+    {"Stop_Sending_Realtime_Coordinate", [](uint32_t i) { Display.Stop_Sending_Realtime_Coordinate(); }},
+    {"Write", [](uint32_t i) { Display.Write(0x41); }},
+    {"Send_Raw(F)", [](uint32_t i) { Display.Send_Raw(F("ref 0")); }},
+#if Nextion_String_Overloads
+    {"Send_Raw(String)", [](uint32_t i) { Display.Send_Raw(String("ref 0")); }},
+#endif
+    {"Send_Raw(const char*)", [](uint32_t i) { Display.Send_Raw("ref 0"); }},
+    {"Send_Raw(const char*,size_t)", [](uint32_t i) { Display.Send_Raw("ref 0", 5); }},
+    {"Clear", [](uint32_t i) { Display.Clear(0x0000); }},
+    {"Refresh(uint16_t)", [](uint32_t i) { Display.Refresh(3); }},
+    {"Refresh(F)", [](uint32_t i) { Display.Refresh(F("t0")); }},
+    {"Refresh(const char*)", [](uint32_t i) { Display.Refresh("t0"); }},
+    {"Delay", [](uint32_t i) { Display.Delay(10); }},
+    {"Click(uint16_t)", [](uint32_t i) { Display.Click(3, 1); }},
+    {"Click(F)", [](uint32_t i) { Display.Click(F("b0"), 1); }},
+    {"Click(const char*)", [](uint32_t i) { Display.Click("b0", 1); }},
+    {"Set_Waveform_Refresh", [](uint32_t i) { Display.Set_Waveform_Refresh(true); }},
+    {"Add_Value_Waveform(1)", [](uint32_t i) { Display.Add_Value_Waveform(1, 0, Samples, 1); }},
+    {"Add_Value_Waveform(256)", [](uint32_t i) { Display.Add_Value_Waveform(1, 0, Samples, sizeof(Samples)); }},
+    {"Add_Value_Waveform(int16_t,4096->400)", [](uint32_t i) { Display.Add_Value_Waveform(1, 0, Samples_16, 4096, 400, -16000, 16000); }},
+    {"Add_Value_Waveform(float,4096->400)", [](uint32_t i) { Display.Add_Value_Waveform(1, 0, Samples_Float, 4096, 400, -1.0f, 1.0f); }},
+    {"Clear_Waveform", [](uint32_t i) { Display.Clear_Waveform(1, 0); }},
+    {"Push_Waveform_Stream", [](uint32_t i) { Display.Push_Waveform_Stream(2, 0, (uint8_t)i); }},
+    {"Get", [](uint32_t i) { Display.Get(F("n0.val")); }},
+    {"Calibrate", [](uint32_t i) { Display.Calibrate(); }},
+    {"Show(F)", [](uint32_t i) { Display.Show(F("t0")); }},
+#if Nextion_String_Overloads
+    {"Show(String)", [](uint32_t i) { Display.Show(Object_Name_String); }},
+#endif
+    {"Show(const char*)", [](uint32_t i) { Display.Show("t0"); }},
+    {"Hide(F)", [](uint32_t i) { Display.Hide(F("t0")); }},
+#if Nextion_String_Overloads
+    {"Hide(String)", [](uint32_t i) { Display.Hide(Object_Name_String); }},
+#endif
+    {"Hide(const char*)", [](uint32_t i) { Display.Hide("t0"); }},
+    {"Set_Touch_Event(F)", [](uint32_t i) { Display.Set_Touch_Event(F("b0"), true); }},
+    {"Set_Touch_Event(const char*)", [](uint32_t i) { Display.Set_Touch_Event("b0", true); }},
+    {"Set_Touch_Event(uint8_t)", [](uint32_t i) { Display.Set_Touch_Event(3, true); }},
+    {"Set_Execution", [](uint32_t i) { Display.Set_Execution(true); }},
+    {"Reboot", [](uint32_t i) { Display.Reboot(); }},
+    {"Set_Value(Number)", [](uint32_t i) { Display.Set_Value(Number, 1234567 + i); }},
+    {"Set_Value(Progress_Bar)", [](uint32_t i) { Display.Set_Value(Progress_Bar, (uint8_t)i); }},
+    {"Set_Text(Text)", [](uint32_t i) { Display.Set_Text(Text, "Hello world"); }},
+    {"Add_Text(Text)", [](uint32_t i) { Display.Add_Text(Text, "abc"); }},
+    {"Set_Picture(Picture)", [](uint32_t i) { Display.Set_Picture(Picture, 3); }},
+    {"Add_Value_Waveform(Waveform)", [](uint32_t i) { Display.Add_Value_Waveform(Waveform, (uint8_t)i); }},
+    {"Clear_Waveform(Waveform)", [](uint32_t i) { Display.Clear_Waveform(Waveform); }},
+    {"Show(Component)", [](uint32_t i) { Display.Show(Text); }},
+    {"Hide(Component)", [](uint32_t i) { Display.Hide(Text); }},
+    {"Set_Value(Number)x8", [](uint32_t i) { for (uint8_t j = 0; j < 8; j++) Display.Set_Value(Number, i + j); }},
+    {"Batch(Set_Value(Number)x8)", [](uint32_t i) { Nextion_Batch_Class Batch(Display); for (uint8_t j = 0; j < 8; j++) Display.Set_Value(Number, i + j); }},
+    {"Batch(Set_Value(Number)x8,Freeze_Refresh)", [](uint32_t i) { Nextion_Batch_Class Batch(Display, true); for (uint8_t j = 0; j < 8; j++) Display.Set_Value(Number, i + j); }},
+    {"Loop(idle)", [](uint32_t i) { Display.Loop(); }},
+};
+
+int main(int Argument_Count, char **Arguments)
+{
+    bool JSON = (Argument_Count > 1 && strcmp(Arguments[1], "--json") == 0);
+
+    for (uint16_t i = 0; i < 4096; i++)
+    {
+        Samples_16[i] = (int16_t)(((i * 37) % 32000) - 16000);
+        Samples_Float[i] = Samples_16[i] / 16000.0f;
+    }
+    for (uint16_t i = 0; i < sizeof(Samples); i++)
+    {
+        Samples[i] = i;
+    }
+
+    Display.Begin(Transport, 921600);
+    Display.Add_Waveform_Stream(2, 0, 256, 128, 0xFFFFFFFF, 0xFF);
+
+    if (!JSON)
+    {
+        printf("method,bytes_per_call,ns_per_call,wire_us_%u,wire_us_%u,calls_per_s_%u,calls_per_s_%u\n", Baud_Rates[0], Baud_Rates[1], Baud_Rates[0], Baud_Rates[1]);
+    }
+
+    for (size_t i = 0; i < sizeof(Benchmarks) / sizeof(Benchmarks[0]); i++)
+    {
+        Benchmarks[i].Function(0); // -- Warm up.
+
+        uint64_t Written_Bytes = Transport.Written_Bytes;
+        std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+        for (uint32_t j = 0; j < Iterations; j++)
+        {
+            Benchmarks[i].Function(j);
+        }
+        double Elapsed_Time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+
+        double Bytes = (double)(Transport.Written_Bytes - Written_Bytes) / Iterations;
+        double Time = Elapsed_Time / Iterations;
+        // -- 10 bits per byte (8N1).
+        double Wire_Time[2] = {Bytes * 10e6 / Baud_Rates[0], Bytes * 10e6 / Baud_Rates[1]};
+        double Calls[2] = {(Bytes > 0) ? 1e6 / Wire_Time[0] : 0, (Bytes > 0) ? 1e6 / Wire_Time[1] : 0};
+
+        if (JSON)
+        {
+            printf("{\"method\":\"%s\",\"bytes_per_call\":%.2f,\"ns_per_call\":%.1f,\"wire_us_%u\":%.1f,\"wire_us_%u\":%.1f,\"calls_per_s_%u\":%.0f,\"calls_per_s_%u\":%.0f}\n",
+                   Benchmarks[i].Name, Bytes, Time, Baud_Rates[0], Wire_Time[0], Baud_Rates[1], Wire_Time[1], Baud_Rates[0], Calls[0], Baud_Rates[1], Calls[1]);
+        }
+        else
+        {
+            printf("\"%s\",%.2f,%.1f,%.1f,%.1f,%.0f,%.0f\n", Benchmarks[i].Name, Bytes, Time, Wire_Time[0], Wire_Time[1], Calls[0], Calls[1]);
+        }
+    }
+
+    return 0;
+}
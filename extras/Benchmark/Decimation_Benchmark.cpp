@@ -0,0 +1,61 @@
+///
+/// @file Decimation_Benchmark.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host benchmark of the waveform decimation kernels.
+/// @details Build and run from this directory :
+///     g++ -std=gnu++11 -O3 -ffast-math -march=native -I../../src Decimation_Benchmark.cpp -o Decimation_Benchmark && ./Decimation_Benchmark
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Decimation.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+static const uint32_t Quantity = 1 << 20;
+static const uint16_t Width = 400;
+static const uint8_t Iterations = 50;
+
+template <typename Type>
+static void Benchmark(const char *Name, const Type *Data, Type Minimum, Type Maximum)
+{
+    static uint8_t Output[Width];
+    uint32_t Checksum = 0;
+
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    for (uint8_t i = 0; i < Iterations; i++)
+    {
+        uint32_t Size = Nextion_Decimate(Data, Quantity, Output, Width, Minimum, Maximum);
+        Checksum += Output[i % Size];
+    }
+    double Elapsed_Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+    printf("%-8s %10.1f Msamples/s (checksum %u)\n", Name, (double)Quantity * Iterations / Elapsed_Time / 1e6, Checksum);
+}
+
+int main()
+{
+    uint8_t *Data_8 = new uint8_t[Quantity];
+    int16_t *Data_16 = new int16_t[Quantity];
+    float *Data_Float = new float[Quantity];
+
+    for (uint32_t i = 0; i < Quantity; i++)
+    {
+        float Value = sinf(i * 0.001f) + ((rand() % 1000) == 0 ? 0.9f : 0.0f); // -- Sine with sparse spikes.
+        Data_8[i] = (uint8_t)((Value + 1.0f) * 100.0f);
+        Data_16[i] = (int16_t)(Value * 16000.0f);
+        Data_Float[i] = Value;
+    }
+
+    Benchmark<uint8_t>("uint8_t", Data_8, 0, 200);
+    Benchmark<int16_t>("int16_t", Data_16, -16000, 16000);
+    Benchmark<float>("float", Data_Float, -1.0f, 1.0f);
+
+    delete[] Data_8;
+    delete[] Data_16;
+    delete[] Data_Float;
+    return 0;
+}
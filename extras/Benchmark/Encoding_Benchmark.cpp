@@ -0,0 +1,132 @@
+///
+/// @file Encoding_Benchmark.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host benchmark of the instruction argument encoding kernels, against the byte at a time reference.
+/// @details Build and run from this directory :
+///     g++ -std=gnu++11 -O2 -I../../src Encoding_Benchmark.cpp -o Encoding_Benchmark && ./Encoding_Benchmark
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Encoding.hpp"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+static const uint32_t Iterations = 200000;
+
+static char Output[4096];
+
+// -- Reference : digits by repeated divisions, in a temporary buffer.
+static size_t Reference_Encode_Number(uint32_t Number, char *Buffer)
+{
+    char Digits[10];
+    uint8_t i = 0;
+    do
+    {
+        Digits[i++] = '0' + (Number % 10);
+        Number /= 10;
+    } while (Number != 0);
+
+    size_t Size = 0;
+    while (i != 0)
+    {
+        Buffer[Size++] = Digits[--i];
+    }
+    return Size;
+}
+
+// -- Reference : one byte at a time.
+static size_t Reference_Escape(const char *Text, char *Buffer)
+{
+    size_t Size = 0;
+    while (*Text != '\0')
+    {
+        if (*Text == '\"' || *Text == '\\')
+        {
+            Buffer[Size++] = '\\';
+        }
+        Buffer[Size++] = *Text;
+        Text++;
+    }
+    return Size;
+}
+
+static size_t Escape(const char *Text, char *Buffer)
+{
+    size_t Text_Size = strlen(Text);
+    size_t Size = 0;
+    while (true)
+    {
+        size_t Run = Nextion_Escape_Run(Text, Text_Size);
+        memcpy(Buffer + Size, Text, Run);
+        Size += Run;
+        Text += Run;
+        Text_Size -= Run;
+        if (Text_Size == 0)
+        {
+            return Size;
+        }
+        Buffer[Size++] = '\\';
+        Buffer[Size++] = *Text;
+        Text++;
+        Text_Size--;
+    }
+}
+
+template <typename Function_Type>
+static double Measure(Function_Type Function, uint32_t &Checksum)
+{
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < Iterations; i++)
+    {
+        Checksum += Function(i);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count() * 1e9 / Iterations;
+}
+
+static void Benchmark_Number(const char *Name, uint32_t Scale)
+{
+    uint32_t Reference_Checksum = 0, Checksum = 0;
+    double Reference_Time = Measure([Scale](uint32_t i) { return Reference_Encode_Number(i * Scale, Output); }, Reference_Checksum);
+    double Time = Measure([Scale](uint32_t i) { return (size_t)Nextion_Encode_Number(i * Scale, Output); }, Checksum);
+
+    printf("%-24s %8.1f ns %8.1f ns  x%.1f%s\n", Name, Reference_Time, Time, Reference_Time / Time, (Checksum == Reference_Checksum) ? "" : "  MISMATCH");
+}
+
+static void Benchmark_Escape(const char *Name, const std::string &Text)
+{
+    std::string Reference_Output(Output, Reference_Escape(Text.c_str(), Output));
+    std::string Fast_Output(Output, Escape(Text.c_str(), Output));
+
+    uint32_t Reference_Checksum = 0, Checksum = 0;
+    double Reference_Time = Measure([&Text](uint32_t) { return Reference_Escape(Text.c_str(), Output); }, Reference_Checksum);
+    double Time = Measure([&Text](uint32_t) { return Escape(Text.c_str(), Output); }, Checksum);
+
+    printf("%-24s %8.1f ns %8.1f ns  x%.1f  %6.0f MB/s%s\n", Name, Reference_Time, Time, Reference_Time / Time, Text.size() / Time * 1e3, (Fast_Output == Reference_Output) ? "" : "  MISMATCH");
+}
+
+int main()
+{
+    printf("%-24s %11s %11s\n", "", "reference", "encoding");
+
+    Benchmark_Number("Number (0 - 200k)", 1);
+    Benchmark_Number("Number (up to 10 digits)", 21475);
+
+    std::string Short_Text = "Hello world";
+    std::string Long_Text;
+    std::string Quoted_Text;
+    for (uint16_t i = 0; i < 1000; i++)
+    {
+        Long_Text += (char)('a' + i % 26);
+        Quoted_Text += (i % 40 == 0) ? '\"' : (i % 97 == 0) ? '\\' : (char)('a' + i % 26);
+    }
+
+    Benchmark_Escape("Text (11 bytes)", Short_Text);
+    Benchmark_Escape("Text (1000 bytes)", Long_Text);
+    Benchmark_Escape("Quoted text (1000 bytes)", Quoted_Text);
+
+    return 0;
+}
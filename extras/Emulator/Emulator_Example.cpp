@@ -0,0 +1,77 @@
+///
+/// @file Emulator_Example.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Drive the emulated display with the library, and report byte counts, latencies and overflows.
+/// @details Build and run from the repository root :
+///     g++ -std=gnu++11 -O2 -Iextras/Host -Isrc -Iextras/Emulator src/*.cpp extras/Host/Host.cpp extras/Emulator/Nextion_Emulator.cpp extras/Emulator/Emulator_Example.cpp -o Emulator_Example -lpthread && ./Emulator_Example
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Emulator.hpp"
+
+#include <stdio.h>
+
+static void Print_Statistics(const char *Name, Nextion_Emulator_Class &Emulator)
+{
+    Nextion_Emulator_Class::Statistics_Type Statistics = Emulator.Get_Statistics();
+    printf("%-12s %6u bytes received, %4u instructions, %3u errors, %4u bytes sent, %4u overflows, buffer peak %4u bytes\n",
+           Name, Statistics.Received_Bytes, Statistics.Instructions, Statistics.Errors, Statistics.Sent_Bytes, Statistics.Overflows, Statistics.Maximum_Buffer_Usage);
+    Emulator.Reset_Statistics();
+}
+
+int main()
+{
+    Nextion_Emulator_Class Emulator(115200, 1024, 100);
+
+    Emulator.Add_Page("Main");
+    Emulator.Add_Component(0, "t0", Nextion_Emulator_Class::Component_Text);
+    Emulator.Add_Component(0, "n0", Nextion_Emulator_Class::Component_Number);
+    uint8_t Waveform_ID = Emulator.Add_Component(0, "s0", Nextion_Emulator_Class::Component_Waveform);
+    Emulator.Add_Page("Settings");
+
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Display.Set_Receive_Task(true);
+    Display.Flush();
+    Emulator.Reset_Statistics();
+
+    // -- Component state.
+    Display.Set_Text("t0", "Hello \"world\"");
+    Display.Set_Value("n0", 1234);
+    Display.Hide("n0");
+    Display.Flush();
+    printf("t0.txt = %s, n0.val = %d, n0 visible = %d\n", Emulator.Get_Text("t0").c_str(), Emulator.Get_Value("n0"), Emulator.Is_Visible("n0"));
+    Print_Statistics("Setters", Emulator);
+
+    // -- Round trip latency.
+    uint32_t Start_Time = micros();
+    uint8_t Page = Display.Get_Current_Page();
+    printf("Page %u read in %lu us\n", Page, micros() - Start_Time);
+    Print_Statistics("sendme", Emulator);
+
+    // -- Transparent transfer.
+    uint8_t Samples[300];
+    for (uint16_t i = 0; i < sizeof(Samples); i++)
+    {
+        Samples[i] = i;
+    }
+    Start_Time = micros();
+    Display.Add_Value_Waveform(Waveform_ID, 0, Samples, sizeof(Samples));
+    printf("%u samples added in %lu us (%u in the channel)\n", (unsigned)sizeof(Samples), micros() - Start_Time, Emulator.Get_Waveform_Size(Waveform_ID, 0));
+    Print_Statistics("addt", Emulator);
+
+    // -- A slow display overflows its input buffer.
+    Emulator.Set_Instruction_Time(5000);
+    for (uint16_t i = 0; i < 200; i++)
+    {
+        Display.Set_Value("n0", i);
+    }
+    Display.Flush();
+    delay(1200);
+    printf("n0.val = %d after the burst\n", Emulator.Get_Value("n0"));
+    Print_Statistics("Burst", Emulator);
+
+    Display.Set_Receive_Task(false);
+    return 0;
+}
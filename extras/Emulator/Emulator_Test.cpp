@@ -0,0 +1,528 @@
+///
+/// @file Emulator_Test.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Behavior tests of the library against the emulated display.
+/// @details Each test runs in its own process, so that a deadlock is reported as a failure instead of blocking the run. Build and run from the repository root :
+///     g++ -std=gnu++11 -O2 -Iextras/Host -Isrc -Iextras/Emulator src/*.cpp extras/Host/Host.cpp extras/Emulator/Nextion_Emulator.cpp extras/Emulator/Emulator_Test.cpp -o Emulator_Test -lpthread && ./Emulator_Test
+/// The exit code is the number of failed tests.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Emulator.hpp"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// -- Time after which a test is considered deadlocked (in seconds).
+static const unsigned int Time_Out = 3;
+
+static Nextion_Class *Display_Pointer = NULL;
+
+static bool Check(bool Condition, const char *Description)
+{
+    if (!Condition)
+    {
+        printf("  failed : %s\n", Description);
+    }
+    return Condition;
+}
+
+///
+/// @brief Call Loop() until a condition is met, or for at most Time milliseconds.
+///
+template <typename Condition_Type>
+static bool Loop_Until(Nextion_Class &Display, Condition_Type Condition, uint32_t Time = 1000)
+{
+    uint32_t Start_Time = millis();
+    while (!Condition())
+    {
+        if ((millis() - Start_Time) > Time)
+        {
+            return false;
+        }
+        Display.Loop();
+        delay(1);
+    }
+    return true;
+}
+
+///
+/// @brief Send the pending instructions and parse their replies.
+///
+static void Drain(Nextion_Class &Display)
+{
+    Display.Flush();
+    Loop_Until(Display, []()
+               { return false; }, 50);
+}
+
+///
+/// @brief Create a page with a text, two numbers and a waveform.
+///
+/// @return ID of the waveform.
+static uint8_t Create_Project(Nextion_Emulator_Class &Emulator)
+{
+    Emulator.Add_Page("Main");
+    Emulator.Add_Component(0, "t0", Nextion_Emulator_Class::Component_Text);
+    Emulator.Add_Component(0, "n0", Nextion_Emulator_Class::Component_Number);
+    Emulator.Add_Component(0, "n1", Nextion_Emulator_Class::Component_Number);
+    return Emulator.Add_Component(0, "s0", Nextion_Emulator_Class::Component_Waveform);
+}
+
+// -- Callbacks sending instructions
+
+static void Set_Value_On_String_Data(const char *String, uint8_t Size)
+{
+    Display_Pointer->Set_Value("n0", Size);
+}
+
+static void Set_Text_On_String_Data(const char *String, uint8_t Size)
+{
+    Display_Pointer->Set_Text("t0", "def");
+}
+
+static uint32_t Successes = 0;
+
+static void Count_Successes(uint8_t Event)
+{
+    if (Event == Nextion_Class::Instruction_Successfull)
+    {
+        Successes++;
+    }
+}
+
+///
+/// @brief A callback sends an instruction while the window of acknowledged mode is full.
+///
+static bool Test_Acknowledged_Callback(bool Receive_Task)
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display_Pointer = &Display;
+    Display.Begin(Emulator, 115200);
+    Display.Set_Text("t0", "abc");
+    Display.Set_Callback_Function_String_Data(Set_Value_On_String_Data);
+    if (Receive_Task)
+    {
+        Display.Set_Receive_Task(true);
+    }
+    Display.Set_Acknowledged_Mode(true, 1);
+    Display.Flush();
+    delay(10);
+    Display.Loop();
+
+    Display.Get("t0.txt"); // -- The answer calls the callback.
+    Display.Set_Value("n1", 5);
+    uint32_t Command = Display.Get_Last_Command();
+
+    bool Passed = Check(Loop_Until(Display, [&Emulator]()
+                                   { return Emulator.Get_Value("n0") == 3; }),
+                        "the callback instruction is executed");
+    Passed &= Check(Loop_Until(Display, [&Display, Command]()
+                               { return Display.Get_Command_Status(Command) == Nextion_Class::Instruction_Successfull; }),
+                    "the instruction sent while the window was full is acknowledged");
+    Passed &= Check(Emulator.Get_Value("n1") == 5, "n1.val == 5");
+
+    Display.Set_Receive_Task(false);
+    return Passed;
+}
+
+static bool Test_Acknowledged_Callback_Loop()
+{
+    return Test_Acknowledged_Callback(false);
+}
+
+static bool Test_Acknowledged_Callback_Receive_Task()
+{
+    return Test_Acknowledged_Callback(true);
+}
+
+///
+/// @brief A callback sends an instruction while a transparent transfer holds the serial semaphore.
+///
+static bool Test_Transparent_Transfer_Callback(bool Receive_Task)
+{
+    Nextion_Emulator_Class Emulator;
+    uint8_t Waveform_ID = Create_Project(Emulator);
+    Nextion_Class Display;
+    Display_Pointer = &Display;
+    Display.Begin(Emulator, 115200);
+    Display.Set_Text("t0", "abc");
+    Drain(Display);
+    Display.Set_Callback_Function_String_Data(Set_Text_On_String_Data);
+    if (Receive_Task)
+    {
+        Display.Set_Receive_Task(true);
+    }
+
+    uint8_t Samples[64];
+    memset(Samples, 128, sizeof(Samples));
+    Display.Get("t0.txt"); // -- The answer arrives during the transfer and calls the callback.
+    Display.Add_Value_Waveform(Waveform_ID, 0, Samples, sizeof(Samples));
+
+    bool Passed = Check(Emulator.Get_Waveform_Size(Waveform_ID, 0) == sizeof(Samples), "the transfer is completed");
+    Passed &= Check(Loop_Until(Display, [&Emulator]()
+                               { return Emulator.Get_Text("t0") == "def"; }),
+                    "the callback instruction is executed");
+
+    Display.Set_Receive_Task(false);
+    return Passed;
+}
+
+static bool Test_Transparent_Transfer_Callback_Loop()
+{
+    return Test_Transparent_Transfer_Callback(false);
+}
+
+static bool Test_Transparent_Transfer_Callback_Receive_Task()
+{
+    return Test_Transparent_Transfer_Callback(true);
+}
+
+///
+/// @brief Frames dropped from the transmit queue leave the window of acknowledged mode, so that the next replies are matched with the right instructions.
+///
+static bool Test_Dropped_Frames_Acknowledged()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+    Display.Set_Asynchronous_Transmission(true, 0, Nextion_Class::Queue_Fail); // -- Smallest queue : a couple of long frames.
+    Display.Set_Acknowledged_Mode(true, 16);
+
+    char Text[201];
+    memset(Text, 'a', sizeof(Text) - 1);
+    Text[sizeof(Text) - 1] = '\0';
+    uint32_t Commands[8];
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        Display.Set_Text("t0", Text);
+        Commands[i] = Display.Get_Last_Command();
+    }
+    Display.Flush();
+    Display.Set_Value("zz", 1); // -- Unknown component : answered by an error.
+    uint32_t Command = Display.Get_Last_Command();
+
+    bool Passed = Check(Loop_Until(Display, [&Display, Command]()
+                                   { return Display.Get_Command_Status(Command) != Nextion_Class::Command_Pending; }),
+                        "the last instruction is answered");
+    uint32_t Dropped = 0;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        uint8_t Status = Display.Get_Command_Status(Commands[i]);
+        Dropped += (Status == Nextion_Class::Command_Dropped);
+        Passed &= Check(Status == Nextion_Class::Command_Dropped || Status == Nextion_Class::Instruction_Successfull, "each instruction is either dropped or acknowledged");
+    }
+    Passed &= Check(Dropped != 0, "frames are dropped");
+    Passed &= Check(Display.Get_Statistics().Dropped_Frames == Dropped, "dropped frames are counted");
+    Passed &= Check(Display.Get_Command_Status(Command) == Nextion_Class::Invalid_Variable_Name_Or_Attribute, "the error is matched with the right instruction");
+    return Passed;
+}
+
+///
+/// @brief The shadow cache only suppresses values the display took : failed and dropped instructions are sent again.
+///
+static bool Test_Shadow_Cache_Failures()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+    Display.Set_Shadow_Cache(8);
+    Display.Set_Acknowledged_Mode(true, 4);
+
+    // -- Failed instruction.
+    Display.Set_Value("zz", 1);
+    Loop_Until(Display, [&Display]()
+               { return Display.Get_Command_Status(Display.Get_Last_Command()) != Nextion_Class::Command_Pending; });
+    uint32_t Errors = Emulator.Get_Statistics().Errors;
+    Display.Set_Value("zz", 1);
+    Drain(Display);
+    bool Passed = Check(Emulator.Get_Statistics().Errors == Errors + 1, "a failed instruction is sent again");
+
+    // -- Dropped instruction.
+    Display.Set_Acknowledged_Mode(false);
+    Display.Set_Asynchronous_Transmission(true, 0, Nextion_Class::Queue_Fail);
+    char Text[201];
+    memset(Text, 'a', sizeof(Text) - 1);
+    Text[sizeof(Text) - 1] = '\0';
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        Display.Set_Text("t0", Text);
+    }
+    Display.Set_Value("n0", 7);
+    Passed &= Check(Display.Get_Statistics().Dropped_Frames != 0, "frames are dropped");
+    Drain(Display);
+    Display.Set_Value("n0", 7);
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Value("n0") == 7, "a dropped instruction is sent again");
+
+    // -- Same value.
+    uint32_t Instructions = Emulator.Get_Statistics().Instructions;
+    Display.Set_Value("n0", 7);
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Statistics().Instructions == Instructions, "the same value is suppressed");
+    return Passed;
+}
+
+///
+/// @brief The decimating overloads reject a pixel budget below 2, and reduce larger ones to Nextion_Maximum_Waveform_Width.
+///
+static bool Test_Decimated_Waveform_Width()
+{
+    Nextion_Emulator_Class Emulator;
+    uint8_t Waveform_ID = Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+
+    static int16_t Samples[2000];
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        Samples[i] = i % 100;
+    }
+    Display.Add_Value_Waveform(Waveform_ID, 0, Samples, 2000, 1, 0, 100);
+    Drain(Display);
+    bool Passed = Check(Emulator.Get_Waveform_Size(Waveform_ID, 0) == 0, "a pixel budget of 1 is rejected");
+    Display.Add_Value_Waveform(Waveform_ID, 0, Samples, 2000, 1000, 0, 100);
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Waveform_Size(Waveform_ID, 0) == Nextion_Maximum_Waveform_Width, "a larger pixel budget is reduced");
+    return Passed;
+}
+
+///
+/// @brief The history of a waveform stream wrapping around the end of its ring is backfilled in a single transfer.
+///
+static bool Test_Waveform_Stream_Backfill()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    uint8_t Page_ID = Emulator.Add_Page("Scope");
+    uint8_t Waveform_ID = Emulator.Add_Component(Page_ID, "s1", Nextion_Emulator_Class::Component_Waveform);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+
+    bool Passed = Check(Display.Add_Waveform_Stream(Waveform_ID, 0, 100, 100, 1000, Page_ID), "the stream is registered");
+    uint8_t Samples[150];
+    for (uint8_t i = 0; i < sizeof(Samples); i++)
+    {
+        Samples[i] = i;
+    }
+    Display.Push_Waveform_Stream(Waveform_ID, 0, Samples, sizeof(Samples)); // -- Hidden : only kept in history, which wraps.
+
+    Emulator.Reset_Statistics();
+    Display.Set_Current_Page(Page_ID, false);
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Waveform_Size(Waveform_ID, 0) == 100, "the history is sent");
+    Passed &= Check(Emulator.Get_Statistics().Instructions == 3, "the history is sent in a single transfer"); // -- page, sendme and addt.
+    return Passed;
+}
+
+///
+/// @brief Set_Text_Format() reports texts truncated to the frame buffer.
+///
+static bool Test_Text_Format_Truncation()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+
+    bool Passed = Check(Display.Set_Text_Format("t0", "%d.%02d V", 12, 5), "a short text is complete");
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Text("t0") == "12.05 V", "t0.txt == \"12.05 V\"");
+
+    char Text[301];
+    memset(Text, 'a', sizeof(Text) - 1);
+    Text[sizeof(Text) - 1] = '\0';
+    Passed &= Check(!Display.Set_Text_Format("t0", "%s", Text), "a text longer than the frame buffer is reported as truncated");
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Text("t0").size() == Nextion_Frame_Buffer_Size - 1, "the truncated text fills the frame buffer");
+    return Passed;
+}
+
+///
+/// @brief Leaving acknowledged mode restores the level set with Set_Debugging(), which is not sent while in acknowledged mode.
+///
+static bool Test_Acknowledged_Mode_Debugging_Level()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Display.Set_Callback_Function_Event(Count_Successes);
+    Display.Set_Debugging(0);
+    Drain(Display); // -- Replies to the instructions sent before acknowledged mode.
+    Display.Set_Acknowledged_Mode(true, 4);
+    Display.Set_Debugging(1);
+
+    Display.Set_Value("n0", 1);
+    uint32_t Command = Display.Get_Last_Command();
+    bool Passed = Check(Loop_Until(Display, [&Display, Command]()
+                                   { return Display.Get_Command_Status(Command) == Nextion_Class::Instruction_Successfull; }),
+                        "instructions are still acknowledged");
+
+    Display.Set_Acknowledged_Mode(false);
+    Drain(Display);
+    Successes = 0;
+    Display.Set_Value("n1", 2);
+    Drain(Display);
+    Passed &= Check(Emulator.Get_Value("n1") == 2, "n1.val == 2");
+    Passed &= Check(Successes == 1, "bkcmd=1 is restored");
+    return Passed;
+}
+
+///
+/// @brief Send a valid, an invalid and a valid instruction in acknowledged mode, and check that each reply is matched with its instruction.
+///
+static bool Check_Acknowledged_Statuses(Nextion_Class &Display)
+{
+    uint32_t Commands[3];
+    Display.Set_Value("n0", 5);
+    Commands[0] = Display.Get_Last_Command();
+    Display.Set_Value("zz", 5);
+    Commands[1] = Display.Get_Last_Command();
+    Display.Set_Value("n0", 6);
+    Commands[2] = Display.Get_Last_Command();
+
+    bool Passed = Check(Loop_Until(Display, [&Display, &Commands]()
+                                   { return Display.Get_Command_Status(Commands[2]) != Nextion_Class::Command_Pending; }),
+                        "the last instruction is answered");
+    Passed &= Check(Display.Get_Command_Status(Commands[0]) == Nextion_Class::Instruction_Successfull, "n0.val=5 is acknowledged");
+    Passed &= Check(Display.Get_Command_Status(Commands[1]) == Nextion_Class::Invalid_Variable_Name_Or_Attribute, "zz.val=5 is rejected");
+    Passed &= Check(Display.Get_Command_Status(Commands[2]) == Nextion_Class::Instruction_Successfull, "n0.val=6 is acknowledged");
+    return Passed;
+}
+
+///
+/// @brief The reply to the reset of Set_Reparse_Mode(0) is not matched with the next instruction in acknowledged mode.
+///
+static bool Test_Acknowledged_Reparse_Mode()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+    Display.Set_Acknowledged_Mode(true, 4);
+
+    Display.Set_Reparse_Mode(0);
+    return Check_Acknowledged_Statuses(Display);
+}
+
+///
+/// @brief The replies to a failed transparent transfer (rejected addt header, then reset) are not matched with the next instructions in acknowledged mode.
+///
+static bool Test_Acknowledged_Failed_Transfer()
+{
+    Nextion_Emulator_Class Emulator;
+    Create_Project(Emulator);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 115200);
+    Drain(Display);
+    Display.Set_Acknowledged_Mode(true, 4);
+
+    uint8_t Samples[16] = {0};
+    Display.Add_Value_Waveform(42, 0, Samples, sizeof(Samples)); // -- Unknown waveform : no 0xFE.
+    bool Passed = Check(Emulator.Get_Waveform_Size(42, 0) == 0, "the transfer fails");
+    Passed &= Check_Acknowledged_Statuses(Display);
+    return Passed;
+}
+
+///
+/// @brief A resumable update (whmi-wris) skips the data the display holds from a partially transferred file.
+///
+static bool Test_Resumed_Update()
+{
+    Nextion_Emulator_Class Emulator(921600);
+    Create_Project(Emulator);
+    Emulator.Set_Update_Resume_Offset(3 * 4096);
+    Nextion_Class Display;
+    Display.Begin(Emulator, 921600);
+    Drain(Display);
+
+    static uint8_t Data[5 * 4096 + 100];
+    char Path[] = "/tmp/Emulator_Test_XXXXXX";
+    int Descriptor = mkstemp(Path);
+    bool Passed = Check(Descriptor >= 0 && write(Descriptor, Data, sizeof(Data)) == sizeof(Data), "the update file is created");
+    if (Descriptor >= 0)
+    {
+        close(Descriptor);
+    }
+
+    Emulator.Reset_Statistics();
+    Passed &= Check(Display.Update(File(Path)) == Nextion_Class::Update_Succeed, "the update succeeds");
+    unlink(Path);
+    // -- The first chunk is sent before the display reports the offset.
+    Passed &= Check(Display.Get_Update_Statistics().Skipped_Bytes == 2 * 4096, "the data held by the display is skipped");
+    Passed &= Check(Emulator.Get_Statistics().Update_Size == sizeof(Data) - 2 * 4096, "only the first chunk and the missing data are sent");
+    return Passed;
+}
+
+typedef struct
+{
+    const char *Name;
+    bool (*Function)();
+} Test_Type;
+
+static const Test_Type Tests[] = {
+    {"Callback sending an instruction in acknowledged mode (Loop)", Test_Acknowledged_Callback_Loop},
+    {"Callback sending an instruction in acknowledged mode (receive task)", Test_Acknowledged_Callback_Receive_Task},
+    {"Callback sending an instruction during a transparent transfer (Loop)", Test_Transparent_Transfer_Callback_Loop},
+    {"Callback sending an instruction during a transparent transfer (receive task)", Test_Transparent_Transfer_Callback_Receive_Task},
+    {"Frames dropped from the transmit queue in acknowledged mode", Test_Dropped_Frames_Acknowledged},
+    {"Shadow cache with failed and dropped instructions", Test_Shadow_Cache_Failures},
+    {"Pixel budget of the decimating waveform overloads", Test_Decimated_Waveform_Width},
+    {"Backfill of a wrapped waveform stream history", Test_Waveform_Stream_Backfill},
+    {"Truncation of formatted texts", Test_Text_Format_Truncation},
+    {"Debugging level restored after acknowledged mode", Test_Acknowledged_Mode_Debugging_Level},
+    {"Reset of Set_Reparse_Mode() in acknowledged mode", Test_Acknowledged_Reparse_Mode},
+    {"Failed transparent transfer in acknowledged mode", Test_Acknowledged_Failed_Transfer},
+    {"Resumed update of a partially transferred file", Test_Resumed_Update},
+};
+
+int main()
+{
+    int Failures = 0;
+
+    for (size_t i = 0; i < sizeof(Tests) / sizeof(Tests[0]); i++)
+    {
+        printf("%s\n", Tests[i].Name);
+        fflush(stdout);
+
+        pid_t Process = fork();
+        if (Process == 0)
+        {
+            alarm(Time_Out);
+            bool Passed = Tests[i].Function();
+            fflush(stdout);
+            _exit(Passed ? 0 : 1);
+        }
+
+        int Status;
+        waitpid(Process, &Status, 0);
+        if (WIFEXITED(Status) && WEXITSTATUS(Status) == 0)
+        {
+            printf("  passed\n");
+            continue;
+        }
+        if (WIFSIGNALED(Status) && WTERMSIG(Status) == SIGALRM)
+        {
+            printf("  failed : deadlock (no progress after %u s)\n", Time_Out);
+        }
+        Failures++;
+    }
+
+    printf("%d failed, %d passed\n", Failures, (int)(sizeof(Tests) / sizeof(Tests[0])) - Failures);
+    return Failures;
+}
@@ -0,0 +1,854 @@
+///
+/// @file Nextion_Emulator.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host behavioral emulator of a Nextion display source file.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Emulator.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+// -- Size of the UART transmit FIFO of the ESP32 : Write() blocks when it is full.
+static const uint8_t Transmit_FIFO_Size = 128;
+
+// -- Size of the chunks of an update acknowledged by the display.
+static const uint32_t Update_Chunk_Size = 4096;
+
+static const uint8_t Terminator[3] = {0xFF, 0xFF, 0xFF};
+
+///
+/// @brief Create an emulator.
+///
+/// @param Baud_Rate Baud rate of the display (the transport starts at the same baud rate).
+/// @param Buffer_Size Size of the serial input buffer of the display (in bytes).
+/// @param Instruction_Time Time taken by the display to execute an instruction (in microseconds).
+Nextion_Emulator_Class::Nextion_Emulator_Class(uint32_t Baud_Rate, uint16_t Buffer_Size, uint32_t Instruction_Time) : Start_Time(std::chrono::steady_clock::now()),
+                                                                                                                    Current_Page(0),
+                                                                                                                    Baud_Rate(Baud_Rate),
+                                                                                                                    Display_Baud_Rate(Baud_Rate),
+                                                                                                                    Buffer_Size(Buffer_Size),
+                                                                                                                    Instruction_Time(Instruction_Time),
+                                                                                                                    Transmit_Time(0),
+                                                                                                                    Answer_Time(0),
+                                                                                                                    Busy_Time(0),
+                                                                                                                    Queued_Bytes(0),
+                                                                                                                    Overflowed(false),
+                                                                                                                    Mode(Mode_Instruction),
+                                                                                                                    Terminator_Count(0),
+                                                                                                                    Remaining_Data(0),
+                                                                                                                    Transparent_Component_ID(0),
+                                                                                                                    Transparent_Channel(0),
+                                                                                                                    Transparent_Ready_Time(0),
+                                                                                                                    Update_Received(0),
+                                                                                                                    Update_Size(0),
+                                                                                                                    Update_Chunk_Received(0),
+                                                                                                                    Update_Resume_Offset(0),
+                                                                                                                    Update_Resumable(false)
+{
+    memset(&Statistics, 0, sizeof(Statistics));
+    System_Variables["bkcmd"] = 2;
+    System_Variables["dim"] = 100;
+    System_Variables["baud"] = Baud_Rate;
+}
+
+// -- Project
+
+///
+/// @brief Add a page to the emulated project.
+///
+/// @param Name Name of the page.
+/// @return Page ID.
+uint8_t Nextion_Emulator_Class::Add_Page(const char *Name)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Page_Type Page;
+    Page.Name = Name;
+    Pages.push_back(Page);
+    return Pages.size() - 1;
+}
+
+///
+/// @brief Add a component to a page of the emulated project. Component IDs are given in order, starting from 1 (0 being the page itself).
+///
+/// @param Page_ID Page of the component.
+/// @param Name Name of the component.
+/// @param Type Type of the component.
+/// @return Component ID, or 0 if the page does not exist.
+uint8_t Nextion_Emulator_Class::Add_Component(uint8_t Page_ID, const char *Name, Component_Types Type)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (Page_ID >= Pages.size())
+    {
+        return 0;
+    }
+    Component_Type Component;
+    Component.Name = Name;
+    Component.ID = Pages[Page_ID].Components.size() + 1;
+    Component.Type = Type;
+    Reset_Component(Component);
+    Pages[Page_ID].Components.push_back(Component);
+    return Component.ID;
+}
+
+// -- State
+
+uint8_t Nextion_Emulator_Class::Get_Current_Page()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Current_Page;
+}
+
+///
+/// @brief Get the text of a component of the current page.
+///
+std::string Nextion_Emulator_Class::Get_Text(const char *Name)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Component_Type *Component = Find_Component(Name);
+    return (Component != NULL) ? Component->Text : std::string();
+}
+
+///
+/// @brief Get the value of a component of the current page.
+///
+int32_t Nextion_Emulator_Class::Get_Value(const char *Name)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Component_Type *Component = Find_Component(Name);
+    return (Component != NULL) ? Component->Value : 0;
+}
+
+///
+/// @brief Get the visibility of a component of the current page.
+///
+bool Nextion_Emulator_Class::Is_Visible(const char *Name)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Component_Type *Component = Find_Component(Name);
+    return (Component != NULL) ? Component->Visible : false;
+}
+
+///
+/// @brief Get the number of samples added to a waveform channel of the current page (since the page was loaded or the channel cleared).
+///
+uint32_t Nextion_Emulator_Class::Get_Waveform_Size(uint8_t Component_ID, uint8_t Channel)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Component_Type *Component = Find_Component(Component_ID);
+    if (Component == NULL || Channel >= 4)
+    {
+        return 0;
+    }
+    return Component->Samples[Channel];
+}
+
+///
+/// @brief Get the baud rate the display currently communicates at.
+///
+uint32_t Nextion_Emulator_Class::Get_Baud_Rate()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Display_Baud_Rate;
+}
+
+Nextion_Emulator_Class::Statistics_Type Nextion_Emulator_Class::Get_Statistics()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Statistics;
+}
+
+void Nextion_Emulator_Class::Reset_Statistics()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    memset(&Statistics, 0, sizeof(Statistics));
+}
+
+///
+/// @brief Set the time taken by the display to execute an instruction.
+///
+/// @param Instruction_Time Time (in microseconds).
+void Nextion_Emulator_Class::Set_Instruction_Time(uint32_t Instruction_Time)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    this->Instruction_Time = Instruction_Time;
+}
+
+///
+/// @brief Set the amount of data the display holds from a previously interrupted resumable update (whmi-wris).
+/// @details The display reports it after the first chunk of the next resumable update, and expects the data from there. It is cleared once an update completes.
+///
+/// @param Offset Offset to resume from (in bytes), 0 to restart from the beginning.
+void Nextion_Emulator_Class::Set_Update_Resume_Offset(uint32_t Offset)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Update_Resume_Offset = Offset;
+}
+
+// -- Transport
+
+///
+/// @details The bytes are processed immediately, but are timestamped with the time they would reach the display. The caller is blocked as long as the transmit FIFO is full, like with an UART.
+size_t Nextion_Emulator_Class::Write(const uint8_t *Data, size_t Size)
+{
+    double Wait_Time;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        double Current_Time = Now();
+        double Byte_Time = 10e6 / Baud_Rate;
+        for (size_t i = 0; i < Size; i++)
+        {
+            Transmit_Time = ((Transmit_Time > Current_Time) ? Transmit_Time : Current_Time) + Byte_Time;
+            Receive(Data[i], Transmit_Time);
+        }
+        Wait_Time = Transmit_Time - Current_Time - (Transmit_FIFO_Size * Byte_Time);
+    }
+    Condition.notify_all();
+    if (Wait_Time > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)Wait_Time));
+    }
+    return Size;
+}
+
+size_t Nextion_Emulator_Class::Available()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    double Current_Time = Now();
+    size_t Available = 0;
+    for (std::deque<Answer_Type>::iterator i = Answers.begin(); i != Answers.end() && i->Time <= Current_Time; ++i)
+    {
+        Available++;
+    }
+    return Available;
+}
+
+size_t Nextion_Emulator_Class::Read(uint8_t *Data, size_t Size)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    double Current_Time = Now();
+    size_t Read = 0;
+    while (Read < Size && !Answers.empty() && Answers.front().Time <= Current_Time)
+    {
+        Data[Read++] = Answers.front().Byte;
+        Answers.pop_front();
+    }
+    return Read;
+}
+
+///
+/// @details Only the baud rate of the library side changes : while it differs from the display one, the bytes are garbled in both directions.
+bool Nextion_Emulator_Class::Set_Baud_Rate(uint32_t Baud_Rate)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    this->Baud_Rate = Baud_Rate;
+    return true;
+}
+
+bool Nextion_Emulator_Class::Wait_For_Data(uint32_t Time_Out)
+{
+    std::unique_lock<std::mutex> Lock(Mutex);
+    double Deadline = Now() + ((Time_Out == 0xFFFFFFFF) ? 1e12 : Time_Out * 1000.0);
+    while (true)
+    {
+        double Current_Time = Now();
+        if (!Answers.empty() && Answers.front().Time <= Current_Time)
+        {
+            return true;
+        }
+        if (Current_Time >= Deadline)
+        {
+            return false;
+        }
+        double Wake_Time = Deadline;
+        if (!Answers.empty() && Answers.front().Time < Wake_Time)
+        {
+            Wake_Time = Answers.front().Time;
+        }
+        Condition.wait_for(Lock, std::chrono::microseconds((uint64_t)(Wake_Time - Current_Time) + 1));
+    }
+}
+
+void Nextion_Emulator_Class::Flush()
+{
+    double Wait_Time;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Wait_Time = Transmit_Time - Now();
+    }
+    if (Wait_Time > 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds((uint64_t)Wait_Time));
+    }
+}
+
+// -- Model
+
+///
+/// @brief Return the time since the emulator creation (in microseconds).
+///
+double Nextion_Emulator_Class::Now()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start_Time).count();
+}
+
+///
+/// @brief Process a byte reaching the display.
+///
+/// @param Byte Received byte.
+/// @param Arrival_Time Time the byte reaches the display.
+void Nextion_Emulator_Class::Receive(uint8_t Byte, double Arrival_Time)
+{
+    Statistics.Received_Bytes++;
+
+    // -- Different baud rates : the display receives garbage.
+    if (Baud_Rate != Display_Baud_Rate)
+    {
+        Statistics.Garbled_Bytes++;
+        Byte = '?';
+    }
+
+    if (Mode == Mode_Transparent)
+    {
+        if (Arrival_Time < Transparent_Ready_Time) // -- Sent before the display was ready : lost.
+        {
+            Statistics.Discarded_Bytes++;
+            return;
+        }
+        Component_Type *Component = Find_Component(Transparent_Component_ID);
+        if (Component != NULL)
+        {
+            Component->Samples[Transparent_Channel]++;
+        }
+        if (--Remaining_Data == 0)
+        {
+            Mode = Mode_Instruction;
+            Answer_Code(Nextion_Class::Transparent_Data_Finished, Arrival_Time + Instruction_Time);
+        }
+        return;
+    }
+
+    if (Mode == Mode_Update)
+    {
+        Update_Received++;
+        Update_Chunk_Received++;
+        Statistics.Update_Size++;
+        if (Update_Received == Update_Size)
+        {
+            Mode = Mode_Instruction;
+            Update_Resume_Offset = 0;
+            Answer_Code(0x05, Arrival_Time + Instruction_Time, false);
+            // -- The display reboots on the new firmware.
+            Reset(Arrival_Time + Instruction_Time);
+        }
+        else if (Update_Chunk_Received == Update_Chunk_Size)
+        {
+            Update_Chunk_Received = 0;
+            if (Update_Resumable && Update_Received == Update_Chunk_Size)
+            {
+                // -- Resumable protocol : the first chunk is answered with the offset of the data already held (0 if none), and the transfer goes on from there.
+                uint32_t Offset = (Update_Resume_Offset > Update_Received && Update_Resume_Offset < Update_Size) ? Update_Resume_Offset : 0;
+                uint8_t Frame[] = {0x08, (uint8_t)Offset, (uint8_t)(Offset >> 8), (uint8_t)(Offset >> 16), (uint8_t)(Offset >> 24)};
+                Answer(Frame, sizeof(Frame), Arrival_Time + Instruction_Time);
+                if (Offset != 0)
+                {
+                    Update_Received = Offset;
+                }
+            }
+            else
+            {
+                Answer_Code(0x05, Arrival_Time + Instruction_Time, false);
+            }
+        }
+        return;
+    }
+
+    // -- Bytes wait in the input buffer until their instruction is executed.
+    while (!Queued_Instructions.empty() && Queued_Instructions.front().Time <= Arrival_Time)
+    {
+        Queued_Bytes -= Queued_Instructions.front().Size;
+        Queued_Instructions.pop_front();
+    }
+    uint32_t Buffer_Usage = Queued_Bytes + Instruction.size() + Terminator_Count;
+    if (Buffer_Usage >= Buffer_Size)
+    {
+        Statistics.Overflows++;
+        if (!Overflowed) // -- Reported once per overflow.
+        {
+            Overflowed = true;
+            Answer_Error(Nextion_Class::Serial_Buffer_Overflow, Arrival_Time);
+        }
+        return;
+    }
+    Overflowed = false;
+    if (Buffer_Usage + 1 > Statistics.Maximum_Buffer_Usage)
+    {
+        Statistics.Maximum_Buffer_Usage = Buffer_Usage + 1;
+    }
+
+    if (Byte != 0xFF)
+    {
+        // -- A lone 0xFF is part of the instruction.
+        Instruction.append(Terminator_Count, (char)0xFF);
+        Terminator_Count = 0;
+        Instruction += (char)Byte;
+        return;
+    }
+
+    if (++Terminator_Count < 3)
+    {
+        return;
+    }
+
+    double Start_Time = (Busy_Time > Arrival_Time) ? Busy_Time : Arrival_Time;
+    Busy_Time = Start_Time + Instruction_Time;
+
+    Queued_Instruction_Type Queued_Instruction = {Busy_Time, (uint32_t)Instruction.size() + 3};
+    Queued_Instructions.push_back(Queued_Instruction);
+    Queued_Bytes += Queued_Instruction.Size;
+
+    std::string Received_Instruction;
+    Received_Instruction.swap(Instruction);
+    Terminator_Count = 0;
+
+    Statistics.Instructions++;
+    Execute(Received_Instruction, Busy_Time);
+}
+
+///
+/// @brief Execute an instruction.
+///
+/// @param Instruction Instruction, without its terminator.
+/// @param Time Time the instruction execution ends.
+void Nextion_Emulator_Class::Execute(std::string const &Instruction, double Time)
+{
+    size_t Separator = Instruction.find_first_of(" =");
+
+    // -- Assignment : "variable=value", "component.attribute=value", "+=" or "-=".
+    if (Separator != std::string::npos && Instruction[Separator] == '=')
+    {
+        std::string Variable = Instruction.substr(0, Separator);
+        std::string Value = Instruction.substr(Separator + 1);
+        char Operator = '=';
+        if (!Variable.empty() && (Variable[Variable.size() - 1] == '+' || Variable[Variable.size() - 1] == '-'))
+        {
+            Operator = Variable[Variable.size() - 1];
+            Variable.erase(Variable.size() - 1);
+        }
+
+        size_t Dot = Variable.find('.');
+        if (Dot == std::string::npos) // -- System variable.
+        {
+            int32_t Number;
+            if (!Parse_Number(Value, Number))
+            {
+                Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+                return;
+            }
+            if (Operator != '=')
+            {
+                Number = System_Variables[Variable] + ((Operator == '+') ? Number : -Number);
+            }
+            System_Variables[Variable] = Number;
+            Answer_Success(Time);
+            if (Variable == "baud") // -- Switch after answering.
+            {
+                Display_Baud_Rate = Number;
+            }
+            return;
+        }
+
+        Component_Type *Component = Find_Component(Variable.substr(0, Dot));
+        std::string Attribute = Variable.substr(Dot + 1);
+        if (Component == NULL)
+        {
+            Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+            return;
+        }
+
+        if (Attribute == "txt")
+        {
+            std::string Text;
+            int32_t Number;
+            if (Operator == '-' && Parse_Number(Value, Number))
+            {
+                Component->Text.erase((Number < (int32_t)Component->Text.size()) ? Component->Text.size() - Number : 0);
+            }
+            else if (Operator != '-' && Parse_String(Value, Text))
+            {
+                Component->Text = (Operator == '+') ? Component->Text + Text : Text;
+            }
+            else
+            {
+                Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+                return;
+            }
+        }
+        else
+        {
+            int32_t Number;
+            if (!Parse_Number(Value, Number))
+            {
+                Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+                return;
+            }
+            int32_t &Current_Value = (Attribute == "val") ? Component->Value : Component->Attributes[Attribute];
+            Current_Value = (Operator == '=') ? Number : Current_Value + ((Operator == '+') ? Number : -Number);
+        }
+        Answer_Success(Time);
+        return;
+    }
+
+    std::string Command = Instruction.substr(0, Separator);
+    std::vector<std::string> Arguments;
+    if (Separator != std::string::npos)
+    {
+        size_t Start = Separator + 1;
+        size_t End;
+        while ((End = Instruction.find(',', Start)) != std::string::npos)
+        {
+            Arguments.push_back(Instruction.substr(Start, End - Start));
+            Start = End + 1;
+        }
+        Arguments.push_back(Instruction.substr(Start));
+    }
+
+    if (Command == "page" && Arguments.size() == 1)
+    {
+        int32_t Page_ID;
+        if (!Parse_Number(Arguments[0], Page_ID))
+        {
+            for (Page_ID = 0; Page_ID < (int32_t)Pages.size() && Pages[Page_ID].Name != Arguments[0]; Page_ID++)
+            {
+            }
+        }
+        if (Page_ID < 0 || Page_ID >= (int32_t)Pages.size())
+        {
+            Answer_Error(Nextion_Class::Invalid_Page_ID, Time);
+            return;
+        }
+        // -- Components are reloaded with their default state (local scope).
+        Current_Page = Page_ID;
+        for (size_t i = 0; i < Pages[Current_Page].Components.size(); i++)
+        {
+            Reset_Component(Pages[Current_Page].Components[i]);
+        }
+        Answer_Success(Time);
+    }
+    else if (Command == "vis" && Arguments.size() == 2)
+    {
+        int32_t Visible;
+        if (!Parse_Number(Arguments[1], Visible))
+        {
+            Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+            return;
+        }
+        if (Arguments[0] == "255")
+        {
+            for (size_t i = 0; Current_Page < Pages.size() && i < Pages[Current_Page].Components.size(); i++)
+            {
+                Pages[Current_Page].Components[i].Visible = Visible != 0;
+            }
+            Answer_Success(Time);
+            return;
+        }
+        Component_Type *Component = Find_Component_Argument(Arguments[0]);
+        if (Component == NULL)
+        {
+            Answer_Error(Nextion_Class::Invalid_Component_ID, Time);
+            return;
+        }
+        Component->Visible = Visible != 0;
+        Answer_Success(Time);
+    }
+    else if (Command == "get" && Arguments.size() == 1)
+    {
+        size_t Dot = Arguments[0].find('.');
+        int32_t Number;
+        if (Dot == std::string::npos)
+        {
+            std::map<std::string, int32_t>::iterator Variable = System_Variables.find(Arguments[0]);
+            if (Variable == System_Variables.end() && !Parse_Number(Arguments[0], Number))
+            {
+                Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+                return;
+            }
+            Answer_Number((Variable != System_Variables.end()) ? Variable->second : Number, Time);
+            return;
+        }
+        Component_Type *Component = Find_Component(Arguments[0].substr(0, Dot));
+        std::string Attribute = Arguments[0].substr(Dot + 1);
+        if (Component == NULL)
+        {
+            Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+        }
+        else if (Attribute == "txt")
+        {
+            uint8_t Code = Nextion_Class::String_Data_Enclosed;
+            Answer(&Code, 1, Time);
+            Answer((const uint8_t *)Component->Text.data(), Component->Text.size(), Time);
+            Answer(Terminator, sizeof(Terminator), Time);
+        }
+        else
+        {
+            Answer_Number((Attribute == "val") ? Component->Value : Component->Attributes[Attribute], Time);
+        }
+    }
+    else if (Command == "sendme")
+    {
+        uint8_t Frame[] = {Nextion_Class::Current_Page_Number, Current_Page, 0xFF, 0xFF, 0xFF};
+        Answer(Frame, sizeof(Frame), Time);
+    }
+    else if ((Command == "add" || Command == "addt" || Command == "cle") && Arguments.size() == ((Command == "cle") ? 2 : 3))
+    {
+        int32_t Component_ID, Channel, Value = 0;
+        if (!Parse_Number(Arguments[0], Component_ID) || !Parse_Number(Arguments[1], Channel) || (Arguments.size() == 3 && !Parse_Number(Arguments[2], Value)))
+        {
+            Answer_Error(Nextion_Class::Invalid_Variable_Name_Or_Attribute, Time);
+            return;
+        }
+        Component_Type *Component = Find_Component((uint8_t)Component_ID);
+        if (Component == NULL || Component->Type != Component_Waveform || Channel < 0 || Channel >= 4)
+        {
+            Answer_Error(Nextion_Class::Invalid_Waveform_ID_Or_Channel, Time);
+            return;
+        }
+        if (Command == "add")
+        {
+            Component->Samples[Channel]++;
+        }
+        else if (Command == "cle")
+        {
+            Component->Samples[Channel] = 0;
+        }
+        else if (Value > 0)
+        {
+            // -- Transparent mode : the display answers when it is ready, then consumes the data.
+            Mode = Mode_Transparent;
+            Remaining_Data = Value;
+            Transparent_Component_ID = Component_ID;
+            Transparent_Channel = Channel;
+            Transparent_Ready_Time = Time;
+            Answer_Code(Nextion_Class::Transparent_Data_Ready, Time);
+            return;
+        }
+        Answer_Success(Time);
+    }
+    else if (Command == "connect")
+    {
+        static const char Information[] = "comok 1,30601-0,NX4832T035_011R,52,61488,D264B8204F0E1828,16777216";
+        Answer((const uint8_t *)Information, sizeof(Information) - 1, Time);
+        Answer(Terminator, sizeof(Terminator), Time);
+    }
+    else if ((Command == "whmi-wri" || Command == "whmi-wris") && Arguments.size() == 3)
+    {
+        int32_t Size, Update_Baud_Rate;
+        if (!Parse_Number(Arguments[0], Size) || !Parse_Number(Arguments[1], Update_Baud_Rate) || Size <= 0)
+        {
+            Answer_Error(Nextion_Class::Invalid_Instruction, Time);
+            return;
+        }
+        // -- The display switches to the update baud rate, then acknowledges.
+        Display_Baud_Rate = Update_Baud_Rate;
+        Mode = Mode_Update;
+        Update_Size = Size;
+        Update_Received = 0;
+        Update_Chunk_Received = 0;
+        Update_Resumable = (Command == "whmi-wris");
+        Answer_Code(0x05, Time, false);
+    }
+    else if (Command == "rest")
+    {
+        Reset(Time);
+    }
+    else if (Command == "ref" || Command == "click" || Command == "tsw" || Command == "ref_stop" || Command == "ref_star" || Command == "com_stop" || Command == "com_star" || Command == "cls" || Command == "xstr" || Command == "xpic" || Command == "pic" || Command == "picq" || Command == "fill" || Command == "line" || Command == "draw" || Command == "cir" || Command == "cirs" || Command == "randset" || Command == "touch_j" || Command == "doevents")
+    {
+        Answer_Success(Time);
+    }
+    else
+    {
+        Answer_Error(Nextion_Class::Invalid_Instruction, Time);
+    }
+}
+
+///
+/// @brief Reset the display : every page is reloaded, the first one is shown and the startup and ready frames are sent.
+///
+void Nextion_Emulator_Class::Reset(double Time)
+{
+    Current_Page = 0;
+    for (size_t i = 0; i < Pages.size(); i++)
+    {
+        for (size_t j = 0; j < Pages[i].Components.size(); j++)
+        {
+            Reset_Component(Pages[i].Components[j]);
+        }
+    }
+    System_Variables["bkcmd"] = 2;
+    Time += Instruction_Time * 100;
+    uint8_t Frames[] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, Nextion_Class::Ready, 0xFF, 0xFF, 0xFF};
+    Answer(Frames, sizeof(Frames), Time);
+}
+
+void Nextion_Emulator_Class::Reset_Component(Component_Type &Component)
+{
+    Component.Text.clear();
+    Component.Value = 0;
+    Component.Visible = true;
+    Component.Attributes.clear();
+    memset(Component.Samples, 0, sizeof(Component.Samples));
+}
+
+///
+/// @brief Send bytes to the library.
+///
+/// @param Time Time the display starts to send.
+void Nextion_Emulator_Class::Answer(const uint8_t *Data, size_t Size, double Time)
+{
+    // -- Different baud rates : the library receives garbage (framing errors are not reported by the UART driver).
+    if (Baud_Rate != Display_Baud_Rate)
+    {
+        return;
+    }
+    double Byte_Time = 10e6 / Display_Baud_Rate;
+    for (size_t i = 0; i < Size; i++)
+    {
+        Answer_Time = ((Answer_Time > Time) ? Answer_Time : Time) + Byte_Time;
+        Answer_Type Byte = {Answer_Time, Data[i]};
+        Answers.push_back(Byte);
+        Statistics.Sent_Bytes++;
+    }
+}
+
+///
+/// @brief Send a return code, optionally followed by the terminator.
+///
+void Nextion_Emulator_Class::Answer_Code(uint8_t Code, double Time, bool Terminated)
+{
+    Answer(&Code, 1, Time);
+    if (Terminated)
+    {
+        Answer(Terminator, sizeof(Terminator), Time);
+    }
+}
+
+///
+/// @brief Send the successful execution return code, if enabled by bkcmd.
+///
+void Nextion_Emulator_Class::Answer_Success(double Time)
+{
+    int32_t Level = System_Variables["bkcmd"];
+    if (Level == 1 || Level == 3)
+    {
+        Answer_Code(Nextion_Class::Instruction_Successfull, Time);
+    }
+}
+
+///
+/// @brief Send an error return code, if enabled by bkcmd.
+///
+void Nextion_Emulator_Class::Answer_Error(uint8_t Code, double Time)
+{
+    Statistics.Errors++;
+    int32_t Level = System_Variables["bkcmd"];
+    if (Level == 2 || Level == 3)
+    {
+        Answer_Code(Code, Time);
+    }
+}
+
+///
+/// @brief Send numeric data (4 bytes little endian).
+///
+void Nextion_Emulator_Class::Answer_Number(int32_t Number, double Time)
+{
+    uint8_t Frame[] = {Nextion_Class::Numeric_Data_Enclosed, (uint8_t)Number, (uint8_t)(Number >> 8), (uint8_t)(Number >> 16), (uint8_t)(Number >> 24), 0xFF, 0xFF, 0xFF};
+    Answer(Frame, sizeof(Frame), Time);
+}
+
+///
+/// @brief Find a component of the current page by name.
+///
+Nextion_Emulator_Class::Component_Type *Nextion_Emulator_Class::Find_Component(std::string const &Name)
+{
+    if (Current_Page >= Pages.size())
+    {
+        return NULL;
+    }
+    for (size_t i = 0; i < Pages[Current_Page].Components.size(); i++)
+    {
+        if (Pages[Current_Page].Components[i].Name == Name)
+        {
+            return &Pages[Current_Page].Components[i];
+        }
+    }
+    return NULL;
+}
+
+///
+/// @brief Find a component of the current page by ID.
+///
+Nextion_Emulator_Class::Component_Type *Nextion_Emulator_Class::Find_Component(uint8_t ID)
+{
+    if (Current_Page >= Pages.size() || ID == 0 || ID > Pages[Current_Page].Components.size())
+    {
+        return NULL;
+    }
+    return &Pages[Current_Page].Components[ID - 1];
+}
+
+///
+/// @brief Find a component of the current page by name or by ID.
+///
+Nextion_Emulator_Class::Component_Type *Nextion_Emulator_Class::Find_Component_Argument(std::string const &Argument)
+{
+    int32_t ID;
+    if (Parse_Number(Argument, ID))
+    {
+        return (ID > 0 && ID < 256) ? Find_Component((uint8_t)ID) : NULL;
+    }
+    return Find_Component(Argument);
+}
+
+bool Nextion_Emulator_Class::Parse_Number(std::string const &Text, int32_t &Number)
+{
+    if (Text.empty())
+    {
+        return false;
+    }
+    char *End;
+    Number = strtol(Text.c_str(), &End, 10);
+    return *End == '\0';
+}
+
+///
+/// @brief Parse a quoted string, with its escape sequences (\" \\ \r).
+///
+bool Nextion_Emulator_Class::Parse_String(std::string const &Text, std::string &String)
+{
+    if (Text.size() < 2 || Text[0] != '"' || Text[Text.size() - 1] != '"')
+    {
+        return false;
+    }
+    String.clear();
+    for (size_t i = 1; i < Text.size() - 1; i++)
+    {
+        if (Text[i] == '\\' && i + 1 < Text.size() - 1)
+        {
+            i++;
+            String += (Text[i] == 'r') ? '\r' : Text[i];
+        }
+        else if (Text[i] == '"') // -- Unescaped quote.
+        {
+            return false;
+        }
+        else
+        {
+            String += Text[i];
+        }
+    }
+    return true;
+}
@@ -0,0 +1,172 @@
+///
+/// @file Nextion_Emulator.hpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host behavioral emulator of a Nextion display, used as a transport.
+/// @details The emulator keeps the state of the components of a project, answers with the return codes of the display and models the wire timing (10 bits per byte at the current baud rate), the instruction processing time and the finite input buffer of the display. Bytes sent by the library reach the emulator when they would reach the display, and its answers are available when they would be received.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_EMULATOR_H_INCLUDED
+#define NEXTION_EMULATOR_H_INCLUDED
+
+#include "Nextion_Library.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Nextion_Emulator_Class : public Nextion_Transport_Class
+{
+public:
+    enum Component_Types
+    {
+        Component_Text,
+        Component_Number,
+        Component_Waveform,
+        Component_Other
+    };
+
+    typedef struct
+    {
+        uint32_t Received_Bytes;
+        uint32_t Sent_Bytes;
+        uint32_t Instructions;
+        uint32_t Errors;
+        uint32_t Overflows;       // -- Bytes dropped because the input buffer was full.
+        uint32_t Garbled_Bytes;   // -- Bytes received at a wrong baud rate.
+        uint32_t Discarded_Bytes; // -- Transparent data sent before the display was ready.
+        uint32_t Maximum_Buffer_Usage;
+        uint32_t Update_Size;
+    } Statistics_Type;
+
+    Nextion_Emulator_Class(uint32_t Baud_Rate = 115200, uint16_t Buffer_Size = 1024, uint32_t Instruction_Time = 100);
+
+    // -- Project
+
+    uint8_t Add_Page(const char *Name);
+    uint8_t Add_Component(uint8_t Page_ID, const char *Name, Component_Types Type);
+
+    // -- State
+
+    uint8_t Get_Current_Page();
+    std::string Get_Text(const char *Name);
+    int32_t Get_Value(const char *Name);
+    bool Is_Visible(const char *Name);
+    uint32_t Get_Waveform_Size(uint8_t Component_ID, uint8_t Channel);
+    uint32_t Get_Baud_Rate();
+    Statistics_Type Get_Statistics();
+    void Reset_Statistics();
+
+    void Set_Instruction_Time(uint32_t Instruction_Time);
+    void Set_Update_Resume_Offset(uint32_t Offset);
+
+    // -- Transport
+
+    size_t Write(const uint8_t *Data, size_t Size);
+    size_t Available();
+    size_t Read(uint8_t *Data, size_t Size);
+    bool Set_Baud_Rate(uint32_t Baud_Rate);
+    bool Wait_For_Data(uint32_t Time_Out);
+    void Flush();
+
+protected:
+    enum Modes
+    {
+        Mode_Instruction,
+        Mode_Transparent, // -- addt data.
+        Mode_Update       // -- whmi-wri / whmi-wris data.
+    };
+
+    typedef struct
+    {
+        std::string Name;
+        uint8_t ID;
+        uint8_t Type;
+        std::string Text;
+        int32_t Value;
+        bool Visible;
+        std::map<std::string, int32_t> Attributes;
+        uint32_t Samples[4];
+    } Component_Type;
+
+    typedef struct
+    {
+        std::string Name;
+        std::vector<Component_Type> Components;
+    } Page_Type;
+
+    typedef struct
+    {
+        double Time;
+        uint8_t Byte;
+    } Answer_Type;
+
+    typedef struct
+    {
+        double Time;
+        uint32_t Size;
+    } Queued_Instruction_Type;
+
+    double Now();
+    void Receive(uint8_t Byte, double Arrival_Time);
+    void Execute(std::string const &Instruction, double Time);
+    void Reset(double Time);
+    void Reset_Component(Component_Type &Component);
+
+    void Answer(const uint8_t *Data, size_t Size, double Time);
+    void Answer_Code(uint8_t Code, double Time, bool Terminated = true);
+    void Answer_Success(double Time);
+    void Answer_Error(uint8_t Code, double Time);
+    void Answer_Number(int32_t Number, double Time);
+
+    Component_Type *Find_Component(std::string const &Name);
+    Component_Type *Find_Component(uint8_t ID);
+    Component_Type *Find_Component_Argument(std::string const &Argument);
+
+    static bool Parse_Number(std::string const &Text, int32_t &Number);
+    static bool Parse_String(std::string const &Text, std::string &String);
+
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    std::chrono::steady_clock::time_point Start_Time;
+
+    std::vector<Page_Type> Pages;
+    uint8_t Current_Page;
+    std::map<std::string, int32_t> System_Variables;
+
+    uint32_t Baud_Rate;         // -- Baud rate of the library side.
+    uint32_t Display_Baud_Rate; // -- Baud rate of the display side.
+    uint16_t Buffer_Size;
+    uint32_t Instruction_Time;
+
+    // -- Timing model (in microseconds since the start)
+    double Transmit_Time; // -- Arrival of the last byte sent by the library.
+    double Answer_Time;   // -- Arrival of the last byte sent by the display.
+    double Busy_Time;     // -- End of the last queued instruction.
+    std::deque<Queued_Instruction_Type> Queued_Instructions;
+    uint32_t Queued_Bytes;
+    bool Overflowed;
+
+    uint8_t Mode;
+    std::string Instruction;
+    uint8_t Terminator_Count;
+    uint32_t Remaining_Data;
+    uint8_t Transparent_Component_ID;
+    uint8_t Transparent_Channel;
+    double Transparent_Ready_Time;
+    uint32_t Update_Received;
+    uint32_t Update_Size;
+    uint32_t Update_Chunk_Received; // -- Bytes received since the last acknowledge.
+    uint32_t Update_Resume_Offset;  // -- Data already held from a previous transfer (whmi-wris).
+    bool Update_Resumable;
+
+    std::deque<Answer_Type> Answers;
+    Statistics_Type Statistics;
+};
+
+#endif
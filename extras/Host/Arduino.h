@@ -0,0 +1,51 @@
+///
+/// @file Arduino.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : the subset of the Arduino-ESP32 core used by the library, on top of the C++ standard library.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_ARDUINO_H_INCLUDED
+#define NEXTION_HOST_ARDUINO_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+// -- Flash strings are regular strings on the host.
+class __FlashStringHelper;
+#define F(Text) (reinterpret_cast<const __FlashStringHelper *>(Text))
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t Time);
+
+class String
+{
+public:
+    String(const char *Text = "") : Text(Text) {}
+    String(std::string const &Text) : Text(Text) {}
+
+    const char *c_str() const { return Text.c_str(); }
+    unsigned int length() const { return Text.length(); }
+
+    String &operator+=(const char *Text)
+    {
+        this->Text += Text;
+        return *this;
+    }
+    bool operator==(const char *Text) const { return this->Text == Text; }
+
+protected:
+    std::string Text;
+};
+
+#endif
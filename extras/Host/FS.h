@@ -0,0 +1,46 @@
+///
+/// @file FS.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : files, on top of stdio.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_FS_H_INCLUDED
+#define NEXTION_HOST_FS_H_INCLUDED
+
+#include "Arduino.h"
+#include <memory>
+
+namespace fs
+{
+    ///
+    /// @brief File handle, shared between copies like on the target.
+    ///
+    class File
+    {
+    public:
+        File() {}
+        File(const char *Path, const char *Mode = "rb");
+
+        operator bool() const { return Handle != NULL; }
+        bool isDirectory() { return false; }
+        size_t size() const;
+        size_t position() const;
+        bool seek(uint32_t Position);
+        int available();
+        int read();
+        size_t read(uint8_t *Buffer, size_t Size);
+        size_t write(const uint8_t *Buffer, size_t Size);
+        const char *name() const { return Path.c_str(); }
+        void close() { Handle.reset(); }
+
+    protected:
+        std::shared_ptr<FILE> Handle;
+        std::string Path;
+    };
+}
+
+using fs::File;
+
+#endif
@@ -0,0 +1,473 @@
+///
+/// @file Host.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer source file.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Arduino.h"
+#include "FS.h"
+#include "Preferences.h"
+#include "freertos/ringbuf.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// -- Time
+
+static const std::chrono::steady_clock::time_point Start_Time = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - Start_Time).count();
+}
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Start_Time).count();
+}
+
+void delay(uint32_t Time)
+{
+    vTaskDelay(pdMS_TO_TICKS(Time));
+}
+
+// -- Tasks
+
+struct Host_Task
+{
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    uint32_t Notifications;
+    volatile bool Deleted;
+
+    Host_Task() : Notifications(0), Deleted(false) {}
+};
+
+// -- Thrown in a deleted task at its next blocking call, to unwind its thread.
+struct Host_Task_Deleted
+{
+};
+
+// -- Task structures are never freed : handles of deleted tasks stay valid, as notifying them is harmless.
+static thread_local Host_Task *Current_Task = NULL;
+
+static Host_Task *Get_Current_Task()
+{
+    if (Current_Task == NULL)
+    {
+        Current_Task = new Host_Task();
+    }
+    return Current_Task;
+}
+
+static void Check_Deleted()
+{
+    if (Get_Current_Task()->Deleted)
+    {
+        throw Host_Task_Deleted();
+    }
+}
+
+///
+/// @brief Wait on a condition until a predicate is true or the ticks elapsed, in slices so that deleted tasks notice it.
+///
+template <typename Predicate>
+static bool Wait(std::unique_lock<std::mutex> &Lock, std::condition_variable &Condition, TickType_t Ticks, Predicate Ready)
+{
+    std::chrono::steady_clock::time_point Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Ticks);
+    while (!Ready())
+    {
+        Lock.unlock();
+        Check_Deleted();
+        Lock.lock();
+
+        std::chrono::steady_clock::time_point Slice = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+        if (Ticks != portMAX_DELAY)
+        {
+            if (std::chrono::steady_clock::now() >= Deadline)
+            {
+                return Ready();
+            }
+            if (Slice > Deadline)
+            {
+                Slice = Deadline;
+            }
+        }
+        Condition.wait_until(Lock, Slice);
+    }
+    return true;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t Function, const char *Name, uint32_t Stack_Size, void *Parameters, UBaseType_t Priority, TaskHandle_t *Handle, BaseType_t Core)
+{
+    Host_Task *Task = new Host_Task();
+    if (Handle != NULL)
+    {
+        *Handle = Task;
+    }
+    std::thread([Task, Function, Parameters]()
+                {
+                    Current_Task = Task;
+                    try
+                    {
+                        Function(Parameters);
+                    }
+                    catch (Host_Task_Deleted &)
+                    {
+                    } })
+        .detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t Function, const char *Name, uint32_t Stack_Size, void *Parameters, UBaseType_t Priority, TaskHandle_t *Handle)
+{
+    return xTaskCreatePinnedToCore(Function, Name, Stack_Size, Parameters, Priority, Handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t Task)
+{
+    if (Task == NULL || Task == Current_Task)
+    {
+        throw Host_Task_Deleted();
+    }
+    std::lock_guard<std::mutex> Lock(Task->Mutex);
+    Task->Deleted = true;
+    Task->Condition.notify_all();
+}
+
+void vTaskDelay(TickType_t Ticks)
+{
+    Host_Task *Task = Get_Current_Task();
+    std::unique_lock<std::mutex> Lock(Task->Mutex);
+    Wait(Lock, Task->Condition, Ticks, []()
+         { return false; });
+}
+
+TickType_t xTaskGetTickCount()
+{
+    return millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    return Get_Current_Task();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t Clear_On_Exit, TickType_t Ticks)
+{
+    Host_Task *Task = Get_Current_Task();
+    std::unique_lock<std::mutex> Lock(Task->Mutex);
+    Wait(Lock, Task->Condition, Ticks, [Task]()
+         { return Task->Notifications != 0; });
+    uint32_t Notifications = Task->Notifications;
+    if (Notifications != 0)
+    {
+        Task->Notifications = Clear_On_Exit ? 0 : Notifications - 1;
+    }
+    return Notifications;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t Task)
+{
+    std::lock_guard<std::mutex> Lock(Task->Mutex);
+    Task->Notifications++;
+    Task->Condition.notify_all();
+    return pdPASS;
+}
+
+// -- Semaphores
+
+struct Host_Semaphore
+{
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    UBaseType_t Count;
+    UBaseType_t Maximum_Count;
+
+    Host_Semaphore(UBaseType_t Maximum_Count, UBaseType_t Initial_Count) : Count(Initial_Count), Maximum_Count(Maximum_Count) {}
+};
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    return new Host_Semaphore(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new Host_Semaphore(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t Maximum_Count, UBaseType_t Initial_Count)
+{
+    return new Host_Semaphore(Maximum_Count, Initial_Count);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Semaphore, TickType_t Ticks)
+{
+    std::unique_lock<std::mutex> Lock(Semaphore->Mutex);
+    if (!Wait(Lock, Semaphore->Condition, Ticks, [Semaphore]()
+              { return Semaphore->Count != 0; }))
+    {
+        return pdFALSE;
+    }
+    Semaphore->Count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Semaphore)
+{
+    std::lock_guard<std::mutex> Lock(Semaphore->Mutex);
+    if (Semaphore->Count >= Semaphore->Maximum_Count)
+    {
+        return pdFALSE;
+    }
+    Semaphore->Count++;
+    Semaphore->Condition.notify_all();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t Semaphore)
+{
+    delete Semaphore;
+}
+
+// -- Ring buffers
+
+struct Host_Ring_Buffer
+{
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    std::deque<std::vector<uint8_t>> Items;
+    std::list<std::vector<uint8_t>> Received_Items; // -- Received, not returned yet : still occupy space.
+    std::list<std::vector<uint8_t>> Acquired_Items; // -- Being written by the sender : occupy space, not received yet.
+    size_t Size;
+    size_t Used;
+
+    Host_Ring_Buffer(size_t Size) : Size(Size), Used(0) {}
+
+    // -- Like ESP-IDF : items are 32 bits aligned and preceded by an 8 bytes header.
+    static size_t Cost(size_t Item_Size)
+    {
+        return ((Item_Size + 3) & ~(size_t)3) + 8;
+    }
+};
+
+RingbufHandle_t xRingbufferCreate(size_t Size, RingbufferType_t Type)
+{
+    return new Host_Ring_Buffer(Size);
+}
+
+void vRingbufferDelete(RingbufHandle_t Ring_Buffer)
+{
+    delete Ring_Buffer;
+}
+
+BaseType_t xRingbufferSend(RingbufHandle_t Ring_Buffer, const void *Data, size_t Size, TickType_t Ticks)
+{
+    size_t Cost = Host_Ring_Buffer::Cost(Size);
+    std::unique_lock<std::mutex> Lock(Ring_Buffer->Mutex);
+    if (Cost > Ring_Buffer->Size / 2)
+    {
+        return pdFALSE;
+    }
+    if (!Wait(Lock, Ring_Buffer->Condition, Ticks, [Ring_Buffer, Cost]()
+              { return Ring_Buffer->Used + Cost <= Ring_Buffer->Size; }))
+    {
+        return pdFALSE;
+    }
+    Ring_Buffer->Items.push_back(std::vector<uint8_t>((const uint8_t *)Data, (const uint8_t *)Data + Size));
+    Ring_Buffer->Used += Cost;
+    Ring_Buffer->Condition.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t Ring_Buffer, void **Item, size_t Size, TickType_t Ticks)
+{
+    size_t Cost = Host_Ring_Buffer::Cost(Size);
+    std::unique_lock<std::mutex> Lock(Ring_Buffer->Mutex);
+    if (Cost > Ring_Buffer->Size / 2)
+    {
+        return pdFALSE;
+    }
+    if (!Wait(Lock, Ring_Buffer->Condition, Ticks, [Ring_Buffer, Cost]()
+              { return Ring_Buffer->Used + Cost <= Ring_Buffer->Size; }))
+    {
+        return pdFALSE;
+    }
+    Ring_Buffer->Acquired_Items.push_back(std::vector<uint8_t>(Size));
+    Ring_Buffer->Used += Cost;
+    *Item = Ring_Buffer->Acquired_Items.back().data();
+    return pdTRUE;
+}
+
+BaseType_t xRingbufferSendComplete(RingbufHandle_t Ring_Buffer, void *Item)
+{
+    std::lock_guard<std::mutex> Lock(Ring_Buffer->Mutex);
+    for (std::list<std::vector<uint8_t>>::iterator i = Ring_Buffer->Acquired_Items.begin(); i != Ring_Buffer->Acquired_Items.end(); i++)
+    {
+        if (i->data() == Item)
+        {
+            Ring_Buffer->Items.push_back(std::vector<uint8_t>());
+            Ring_Buffer->Items.back().swap(*i);
+            Ring_Buffer->Acquired_Items.erase(i);
+            Ring_Buffer->Condition.notify_all();
+            return pdTRUE;
+        }
+    }
+    return pdFALSE;
+}
+
+void *xRingbufferReceive(RingbufHandle_t Ring_Buffer, size_t *Size, TickType_t Ticks)
+{
+    std::unique_lock<std::mutex> Lock(Ring_Buffer->Mutex);
+    if (!Wait(Lock, Ring_Buffer->Condition, Ticks, [Ring_Buffer]()
+              { return !Ring_Buffer->Items.empty(); }))
+    {
+        return NULL;
+    }
+    Ring_Buffer->Received_Items.push_back(std::vector<uint8_t>());
+    Ring_Buffer->Received_Items.back().swap(Ring_Buffer->Items.front());
+    Ring_Buffer->Items.pop_front();
+    *Size = Ring_Buffer->Received_Items.back().size();
+    return Ring_Buffer->Received_Items.back().data();
+}
+
+void vRingbufferReturnItem(RingbufHandle_t Ring_Buffer, void *Item)
+{
+    std::lock_guard<std::mutex> Lock(Ring_Buffer->Mutex);
+    for (std::list<std::vector<uint8_t>>::iterator i = Ring_Buffer->Received_Items.begin(); i != Ring_Buffer->Received_Items.end(); i++)
+    {
+        if (i->data() == Item)
+        {
+            Ring_Buffer->Used -= Host_Ring_Buffer::Cost(i->size());
+            Ring_Buffer->Received_Items.erase(i);
+            Ring_Buffer->Condition.notify_all();
+            return;
+        }
+    }
+}
+
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t Ring_Buffer)
+{
+    std::lock_guard<std::mutex> Lock(Ring_Buffer->Mutex);
+    return Ring_Buffer->Size - Ring_Buffer->Used;
+}
+
+// -- Files
+
+namespace fs
+{
+    File::File(const char *Path, const char *Mode) : Path(Path)
+    {
+        FILE *Handle = fopen(Path, Mode);
+        if (Handle != NULL)
+        {
+            this->Handle.reset(Handle, fclose);
+        }
+    }
+
+    size_t File::size() const
+    {
+        long Position = ftell(Handle.get());
+        fseek(Handle.get(), 0, SEEK_END);
+        long Size = ftell(Handle.get());
+        fseek(Handle.get(), Position, SEEK_SET);
+        return Size;
+    }
+
+    size_t File::position() const
+    {
+        return ftell(Handle.get());
+    }
+
+    bool File::seek(uint32_t Position)
+    {
+        return fseek(Handle.get(), Position, SEEK_SET) == 0;
+    }
+
+    int File::available()
+    {
+        return size() - position();
+    }
+
+    int File::read()
+    {
+        return fgetc(Handle.get());
+    }
+
+    size_t File::read(uint8_t *Buffer, size_t Size)
+    {
+        return fread(Buffer, 1, Size, Handle.get());
+    }
+
+    size_t File::write(const uint8_t *Buffer, size_t Size)
+    {
+        return fwrite(Buffer, 1, Size, Handle.get());
+    }
+}
+
+// -- Preferences
+
+static std::mutex Preferences_Mutex;
+static std::map<std::string, uint32_t> Preferences_Values;
+
+bool Preferences::begin(const char *Name, bool Read_Only)
+{
+    this->Name = Name;
+    this->Read_Only = Read_Only;
+    return true;
+}
+
+uint32_t Preferences::getUInt(const char *Key, uint32_t Default_Value)
+{
+    std::lock_guard<std::mutex> Lock(Preferences_Mutex);
+    std::map<std::string, uint32_t>::iterator Value = Preferences_Values.find(Name + "/" + Key);
+    return (Value == Preferences_Values.end()) ? Default_Value : Value->second;
+}
+
+size_t Preferences::putUInt(const char *Key, uint32_t Value)
+{
+    if (Read_Only)
+    {
+        return 0;
+    }
+    std::lock_guard<std::mutex> Lock(Preferences_Mutex);
+    Preferences_Values[Name + "/" + Key] = Value;
+    return sizeof(Value);
+}
+
+bool Preferences::remove(const char *Key)
+{
+    std::lock_guard<std::mutex> Lock(Preferences_Mutex);
+    return !Read_Only && Preferences_Values.erase(Name + "/" + Key) != 0;
+}
+
+bool Preferences::clear()
+{
+    if (Read_Only)
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> Lock(Preferences_Mutex);
+    std::string Prefix = Name + "/";
+    for (std::map<std::string, uint32_t>::iterator i = Preferences_Values.begin(); i != Preferences_Values.end();)
+    {
+        if (i->first.compare(0, Prefix.size(), Prefix) == 0)
+        {
+            i = Preferences_Values.erase(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+    return true;
+}
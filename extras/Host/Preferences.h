@@ -0,0 +1,30 @@
+///
+/// @file Preferences.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : non volatile storage, kept in memory.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_PREFERENCES_H_INCLUDED
+#define NEXTION_HOST_PREFERENCES_H_INCLUDED
+
+#include "Arduino.h"
+
+class Preferences
+{
+public:
+    bool begin(const char *Name, bool Read_Only = false);
+    void end() {}
+
+    uint32_t getUInt(const char *Key, uint32_t Default_Value = 0);
+    size_t putUInt(const char *Key, uint32_t Value);
+    bool remove(const char *Key);
+    bool clear();
+
+protected:
+    std::string Name;
+    bool Read_Only;
+};
+
+#endif
@@ -0,0 +1,30 @@
+///
+/// @file FreeRTOS.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : FreeRTOS types. One tick is one millisecond.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_FREERTOS_H_INCLUDED
+#define NEXTION_HOST_FREERTOS_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL pdFALSE
+#define pdPASS pdTRUE
+
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(Time) ((TickType_t)(Time))
+
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+#endif
@@ -0,0 +1,30 @@
+///
+/// @file ringbuf.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : ESP-IDF no-split ring buffers.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_RINGBUF_H_INCLUDED
+#define NEXTION_HOST_RINGBUF_H_INCLUDED
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct Host_Ring_Buffer *RingbufHandle_t;
+
+typedef enum
+{
+    RINGBUF_TYPE_NOSPLIT = 0,
+} RingbufferType_t;
+
+RingbufHandle_t xRingbufferCreate(size_t Size, RingbufferType_t Type);
+void vRingbufferDelete(RingbufHandle_t Ring_Buffer);
+BaseType_t xRingbufferSend(RingbufHandle_t Ring_Buffer, const void *Data, size_t Size, TickType_t Ticks);
+BaseType_t xRingbufferSendAcquire(RingbufHandle_t Ring_Buffer, void **Item, size_t Size, TickType_t Ticks);
+BaseType_t xRingbufferSendComplete(RingbufHandle_t Ring_Buffer, void *Item);
+void *xRingbufferReceive(RingbufHandle_t Ring_Buffer, size_t *Size, TickType_t Ticks);
+void vRingbufferReturnItem(RingbufHandle_t Ring_Buffer, void *Item);
+size_t xRingbufferGetCurFreeSize(RingbufHandle_t Ring_Buffer);
+
+#endif
@@ -0,0 +1,23 @@
+///
+/// @file semphr.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : semaphores.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_SEMPHR_H_INCLUDED
+#define NEXTION_HOST_SEMPHR_H_INCLUDED
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct Host_Semaphore *SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t Maximum_Count, UBaseType_t Initial_Count);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t Semaphore, TickType_t Ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t Semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t Semaphore);
+
+#endif
@@ -0,0 +1,28 @@
+///
+/// @file task.h
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Host portability layer : tasks (threads) and task notifications.
+/// @details Deleting another task takes effect at its next blocking call. Deleting the main thread is not supported.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_HOST_TASK_H_INCLUDED
+#define NEXTION_HOST_TASK_H_INCLUDED
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct Host_Task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t Function, const char *Name, uint32_t Stack_Size, void *Parameters, UBaseType_t Priority, TaskHandle_t *Handle, BaseType_t Core);
+BaseType_t xTaskCreate(TaskFunction_t Function, const char *Name, uint32_t Stack_Size, void *Parameters, UBaseType_t Priority, TaskHandle_t *Handle);
+void vTaskDelete(TaskHandle_t Task);
+void vTaskDelay(TickType_t Ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+
+uint32_t ulTaskNotifyTake(BaseType_t Clear_On_Exit, TickType_t Ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t Task);
+
+#endif
@@ -0,0 +1,301 @@
+///
+/// @file Replay.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Replay a capture of received bytes (Nextion_Recording_Transport_Class) through the parser, check the decoded events and measure its throughput.
+/// @details Build from the repository root :
+///     g++ -std=gnu++11 -O2 -Iextras/Host -Isrc src/*.cpp extras/Host/Host.cpp extras/Replay/Replay.cpp -o Replay -lpthread
+/// Usage :
+///     ./Replay Capture.nxrx                    Print the decoded events and the throughput.
+///     ./Replay Capture.nxrx Expected.txt       Check the decoded events against the expected ones (exit code 1 on mismatch).
+///     ./Replay Capture.nxrx --write Expected.txt   Write the decoded events.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Library.hpp"
+
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// -- Minimum replay time of the throughput measurement (in seconds).
+static const double Measure_Time = 1.0;
+
+///
+/// @brief Transport returning the captured bytes, one record per Loop() call.
+///
+class Replay_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Replay_Transport_Class() : Record(0),
+                               Position(0)
+    {
+    }
+
+    size_t Write(const uint8_t *Data, size_t Size)
+    {
+        return Size;
+    }
+
+    size_t Available()
+    {
+        return (Record < Records.size()) ? Records[Record].size() - Position : 0;
+    }
+
+    size_t Read(uint8_t *Data, size_t Size)
+    {
+        size_t Available = this->Available();
+        if (Size > Available)
+        {
+            Size = Available;
+        }
+        memcpy(Data, Records[Record].data() + Position, Size);
+        Position += Size;
+        return Size;
+    }
+
+    bool Set_Baud_Rate(uint32_t Baud_Rate)
+    {
+        return true;
+    }
+
+    bool Wait_For_Data(uint32_t Time_Out)
+    {
+        return Available() > 0;
+    }
+
+    void Flush()
+    {
+    }
+
+    ///
+    /// @brief Move to the next record, once the current one is parsed.
+    ///
+    /// @return false when every record has been replayed.
+    bool Next_Record()
+    {
+        if (Record < Records.size() && Position >= Records[Record].size())
+        {
+            Record++;
+            Position = 0;
+        }
+        return Record < Records.size();
+    }
+
+    void Rewind()
+    {
+        Record = 0;
+        Position = 0;
+    }
+
+    std::vector<std::vector<uint8_t>> Records;
+
+protected:
+    size_t Record;
+    size_t Position;
+};
+
+static Replay_Transport_Class Transport;
+static Nextion_Class Display;
+
+static std::vector<std::string> Events;
+
+static void Log_String_Data(const char *String, uint8_t Size)
+{
+    std::string Event = "string " + std::to_string(Size) + " \"";
+    for (uint8_t i = 0; i < Size; i++)
+    {
+        uint8_t Character = String[i];
+        if (isprint(Character) && Character != '\\' && Character != '"')
+        {
+            Event += (char)Character;
+        }
+        else
+        {
+            char Escaped[5];
+            snprintf(Escaped, sizeof(Escaped), "\\x%02X", Character);
+            Event += Escaped;
+        }
+    }
+    Events.push_back(Event + "\"");
+}
+
+static void Log_Numeric_Data(uint32_t Value)
+{
+    Events.push_back("number " + std::to_string(Value));
+}
+
+static void Log_Event(uint8_t Code)
+{
+    char Event[32];
+    if (Code == Nextion_Class::Current_Page_Number)
+    {
+        snprintf(Event, sizeof(Event), "event 0x%02X page %u", Code, Display.Get_Current_Page(false));
+    }
+    else
+    {
+        snprintf(Event, sizeof(Event), "event 0x%02X", Code);
+    }
+    Events.push_back(Event);
+}
+
+static void Ignore_String_Data(const char *, uint8_t)
+{
+}
+
+static void Ignore_Numeric_Data(uint32_t)
+{
+}
+
+static void Ignore_Event(uint8_t)
+{
+}
+
+///
+/// @brief Read a capture file into records.
+///
+static bool Read_Capture(const char *Path, std::vector<std::vector<uint8_t>> &Records, size_t &Size)
+{
+    FILE *File = fopen(Path, "rb");
+    if (File == NULL)
+    {
+        return false;
+    }
+    uint8_t Header[6];
+    if (fread(Header, 1, 5, File) != 5 || memcmp(Header, "NXRX", 4) != 0 || Header[4] != 1)
+    {
+        fclose(File);
+        return false;
+    }
+    Size = 0;
+    while (fread(Header, 1, 6, File) == 6)
+    {
+        std::vector<uint8_t> Record(Header[4] | (Header[5] << 8));
+        if (fread(Record.data(), 1, Record.size(), File) != Record.size())
+        {
+            fclose(File);
+            return false;
+        }
+        Size += Record.size();
+        Records.push_back(Record);
+    }
+    fclose(File);
+    return true;
+}
+
+///
+/// @brief Replay every record through the parser.
+///
+static void Replay()
+{
+    Transport.Rewind();
+    do
+    {
+        Display.Loop();
+    } while (Transport.Next_Record());
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+    if (Argument_Count < 2)
+    {
+        fprintf(stderr, "Usage : %s Capture.nxrx [Expected.txt | --write Expected.txt]\n", Arguments[0]);
+        return 2;
+    }
+
+    size_t Capture_Size;
+    if (!Read_Capture(Arguments[1], Transport.Records, Capture_Size))
+    {
+        fprintf(stderr, "Cannot read capture %s\n", Arguments[1]);
+        return 2;
+    }
+
+    Display.Begin(Transport, 921600);
+
+    // -- Decoded events.
+    Display.Set_Callback_Function_String_Data(Log_String_Data);
+    Display.Set_Callback_Function_Numeric_Data(Log_Numeric_Data);
+    Display.Set_Callback_Function_Event(Log_Event);
+    Replay();
+
+    int Result = 0;
+    if (Argument_Count == 2)
+    {
+        for (size_t i = 0; i < Events.size(); i++)
+        {
+            printf("%s\n", Events[i].c_str());
+        }
+    }
+    else if (Argument_Count == 4 && strcmp(Arguments[2], "--write") == 0)
+    {
+        FILE *File = fopen(Arguments[3], "w");
+        if (File == NULL)
+        {
+            fprintf(stderr, "Cannot write %s\n", Arguments[3]);
+            return 2;
+        }
+        for (size_t i = 0; i < Events.size(); i++)
+        {
+            fprintf(File, "%s\n", Events[i].c_str());
+        }
+        fclose(File);
+    }
+    else
+    {
+        FILE *File = fopen(Arguments[2], "r");
+        if (File == NULL)
+        {
+            fprintf(stderr, "Cannot read %s\n", Arguments[2]);
+            return 2;
+        }
+        std::vector<std::string> Expected_Events;
+        char Line[512];
+        while (fgets(Line, sizeof(Line), File) != NULL)
+        {
+            Line[strcspn(Line, "\r\n")] = '\0';
+            Expected_Events.push_back(Line);
+        }
+        fclose(File);
+
+        for (size_t i = 0; i < Expected_Events.size() || i < Events.size(); i++)
+        {
+            const char *Expected = (i < Expected_Events.size()) ? Expected_Events[i].c_str() : "(none)";
+            const char *Decoded = (i < Events.size()) ? Events[i].c_str() : "(none)";
+            if (strcmp(Expected, Decoded) != 0)
+            {
+                printf("Mismatch at event %u :\n  expected %s\n  decoded  %s\n", (unsigned)i + 1, Expected, Decoded);
+                Result = 1;
+                break;
+            }
+        }
+        if (Result == 0)
+        {
+            printf("%u events match\n", (unsigned)Events.size());
+        }
+    }
+
+    // -- Throughput, without logging.
+    Display.Set_Callback_Function_String_Data(Ignore_String_Data);
+    Display.Set_Callback_Function_Numeric_Data(Ignore_Numeric_Data);
+    Display.Set_Callback_Function_Event(Ignore_Event);
+    Display.Reset_Statistics();
+
+    uint32_t Iterations = 0;
+    double Elapsed_Time = 0;
+    std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+    while (Elapsed_Time < Measure_Time)
+    {
+        Replay();
+        Iterations++;
+        Elapsed_Time = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    }
+
+    uint32_t Frames = Display.Get_Statistics().Received_Frames;
+    fprintf((Argument_Count == 2) ? stderr : stdout, "%u frames, %u bytes : %.0f frames/s, %.1f MB/s, %.1f ns/frame\n",
+            Frames / Iterations, (unsigned)Capture_Size, Frames / Elapsed_Time, (double)Capture_Size * Iterations / Elapsed_Time / 1e6, (Frames != 0) ? Elapsed_Time * 1e9 / Frames : 0);
+
+    return Result;
+}
@@ -0,0 +1,302 @@
+///
+/// @file Trace_Decoder.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Decode a protocol trace dumped by Nextion_Class::Dump_Trace() into a readable timeline.
+/// @details The trace is read from a file (or the standard input), either as the raw blob or as its hexadecimal representation (whitespace ignored), as printed on a serial console. Build and run from the repository root :
+///     g++ -std=gnu++11 -Iextras/Host -Isrc extras/Trace/Trace_Decoder.cpp -o Trace_Decoder && ./Trace_Decoder trace.hex
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Library.hpp"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+typedef struct
+{
+    uint8_t Code;
+    const char *Name;
+} Code_Name_Type;
+
+// -- Return codes, named after the Errors and Informations enumerations.
+static const Code_Name_Type Code_Names[] = {
+    {Nextion_Class::Invalid_Instruction, "Invalid_Instruction"},
+    {Nextion_Class::Instruction_Successfull, "Instruction_Successfull"},
+    {Nextion_Class::Invalid_Component_ID, "Invalid_Component_ID"},
+    {Nextion_Class::Invalid_Page_ID, "Invalid_Page_ID"},
+    {Nextion_Class::Invalid_Picture_ID, "Invalid_Picture_ID"},
+    {Nextion_Class::Invalid_Font_ID, "Invalid_Font_ID"},
+    {Nextion_Class::Invalid_File_Operation, "Invalid_File_Operation"},
+    {Nextion_Class::Invalid_CRC, "Invalid_CRC"},
+    {Nextion_Class::Invalid_Baud_Rate_Setting, "Invalid_Baud_Rate_Setting"},
+    {Nextion_Class::Invalid_Waveform_ID_Or_Channel, "Invalid_Waveform_ID_Or_Channel"},
+    {Nextion_Class::Invalid_Variable_Name_Or_Attribute, "Invalid_Variable_Name_Or_Attribute"},
+    {Nextion_Class::Invalid_Variable_Operation, "Invalid_Variable_Operation"},
+    {Nextion_Class::Fail_To_Assign, "Fail_To_Assign"},
+    {Nextion_Class::Fail_EEPROM_Operation, "Fail_EEPROM_Operation"},
+    {Nextion_Class::Invalid_Quantity_Of_Parameters, "Invalid_Quantity_Of_Parameters"},
+    {Nextion_Class::IO_Operation_Failed, "IO_Operation_Failed"},
+    {Nextion_Class::Invalid_Escape_Character, "Invalid_Escape_Character"},
+    {Nextion_Class::Too_Long_Variable_Name, "Too_Long_Variable_Name"},
+    {Nextion_Class::Serial_Buffer_Overflow, "Serial_Buffer_Overflow"},
+    {Nextion_Class::Touch_Event, "Touch_Event"},
+    {Nextion_Class::Current_Page_Number, "Current_Page_Number"},
+    {Nextion_Class::Touch_Coordinate_Awake, "Touch_Coordinate_Awake"},
+    {Nextion_Class::Touch_Coordinate_Sleep, "Touch_Coordinate_Sleep"},
+    {Nextion_Class::String_Data_Enclosed, "String_Data_Enclosed"},
+    {Nextion_Class::Numeric_Data_Enclosed, "Numeric_Data_Enclosed"},
+    {Nextion_Class::Auto_Entered_Sleep_Mode, "Auto_Entered_Sleep_Mode"},
+    {Nextion_Class::Auto_Wake_From_Sleep_Mode, "Auto_Wake_From_Sleep_Mode"},
+    {Nextion_Class::Ready, "Ready"},
+    {Nextion_Class::Start_Upgrade_From_SD, "Start_Upgrade_From_SD"},
+    {Nextion_Class::Transparent_Data_Finished, "Transparent_Data_Finished"},
+    {Nextion_Class::Transparent_Data_Ready, "Transparent_Data_Ready"},
+};
+
+static const char *Get_Code_Name(uint8_t Code)
+{
+    for (size_t i = 0; i < sizeof(Code_Names) / sizeof(Code_Names[0]); i++)
+    {
+        if (Code_Names[i].Code == Code)
+        {
+            return Code_Names[i].Name;
+        }
+    }
+    return "Unknown";
+}
+
+///
+/// @brief Read the whole input, converting it from hexadecimal if it only contains hexadecimal digits and whitespace.
+///
+static bool Read_Input(FILE *File, std::vector<uint8_t> &Blob)
+{
+    std::vector<uint8_t> Input;
+    int Character;
+    while ((Character = fgetc(File)) != EOF)
+    {
+        Input.push_back(Character);
+    }
+
+    bool Hexadecimal = true;
+    for (size_t i = 0; i < Input.size() && Hexadecimal; i++)
+    {
+        Hexadecimal = isxdigit(Input[i]) || isspace(Input[i]);
+    }
+    if (!Hexadecimal || Input.size() < 8)
+    {
+        Blob.swap(Input);
+        return true;
+    }
+
+    std::string Digits;
+    for (size_t i = 0; i < Input.size(); i++)
+    {
+        if (isxdigit(Input[i]))
+        {
+            Digits += (char)Input[i];
+        }
+    }
+    if (Digits.size() % 2 != 0)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < Digits.size(); i += 2)
+    {
+        Blob.push_back(strtoul(Digits.substr(i, 2).c_str(), NULL, 16));
+    }
+    return true;
+}
+
+///
+/// @brief Print a transmitted frame : the name of each instruction, then the instruction with its non printable bytes escaped.
+///
+static void Print_Transmitted(const uint8_t *Data, uint16_t Recorded_Size, uint16_t Size)
+{
+    // -- Raw data (transparent mode, update) : mostly non printable.
+    uint16_t Printable = 0;
+    for (uint16_t i = 0; i < Recorded_Size; i++)
+    {
+        Printable += (isprint(Data[i]) || Data[i] == 0xFF) ? 1 : 0;
+    }
+    if (Printable * 2 < Recorded_Size)
+    {
+        printf("%-12s %u bytes :", "data", Size);
+        for (uint16_t i = 0; i < Recorded_Size; i++)
+        {
+            printf(" %02X", Data[i]);
+        }
+        printf("%s\n", (Recorded_Size < Size) ? " ..." : "");
+        return;
+    }
+
+    // -- A frame may hold several instructions.
+    uint16_t Start = 0;
+    bool First = true;
+    while (Start < Recorded_Size)
+    {
+        uint16_t End = Start;
+        while (End < Recorded_Size && !(End + 2 < Recorded_Size && Data[End] == 0xFF && Data[End + 1] == 0xFF && Data[End + 2] == 0xFF))
+        {
+            End++;
+        }
+
+        std::string Instruction;
+        for (uint16_t i = Start; i < End; i++)
+        {
+            if (isprint(Data[i]))
+            {
+                Instruction += (char)Data[i];
+            }
+            else
+            {
+                char Escaped[5];
+                snprintf(Escaped, sizeof(Escaped), "\\x%02X", Data[i]);
+                Instruction += Escaped;
+            }
+        }
+        std::string Name = Instruction.substr(0, Instruction.find_first_of(" ="));
+
+        printf("%s%-12s %s%s\n", First ? "" : "                                   ", Name.c_str(), Instruction.c_str(), (End >= Recorded_Size && Recorded_Size < Size) ? " ..." : "");
+        First = false;
+        Start = End + 3;
+    }
+}
+
+///
+/// @brief Print a received frame : the name of its return code, then its decoded payload.
+///
+static void Print_Received(const uint8_t *Data, uint16_t Recorded_Size, uint16_t Size)
+{
+    if (Recorded_Size == 0)
+    {
+        printf("(empty)\n");
+        return;
+    }
+
+    uint8_t Code = Data[0];
+    const uint8_t *Payload = Data + 1;
+    uint16_t Payload_Size = Recorded_Size - 1;
+
+    if (Code == Nextion_Class::Invalid_Instruction && Size == 3 && Payload_Size == 2 && Payload[0] == 0 && Payload[1] == 0)
+    {
+        printf("%-12s (0x00 0x00 0x00)\n", "Startup");
+        return;
+    }
+
+    printf("%s (0x%02X)", Get_Code_Name(Code), Code);
+    switch (Code)
+    {
+    case Nextion_Class::Current_Page_Number:
+        if (Payload_Size >= 1)
+        {
+            printf(" page %u", Payload[0]);
+        }
+        break;
+    case Nextion_Class::Numeric_Data_Enclosed:
+        if (Payload_Size >= 4)
+        {
+            uint32_t Value = ((uint32_t)Payload[3] << 24) | ((uint32_t)Payload[2] << 16) | ((uint32_t)Payload[1] << 8) | Payload[0];
+            printf(" %u (%d)", Value, (int32_t)Value);
+        }
+        break;
+    case Nextion_Class::String_Data_Enclosed:
+        printf(" \"");
+        for (uint16_t i = 0; i < Payload_Size; i++)
+        {
+            printf(isprint(Payload[i]) ? "%c" : "\\x%02X", Payload[i]);
+        }
+        printf("\"%s", (Recorded_Size < Size) ? " ..." : "");
+        break;
+    case Nextion_Class::Touch_Event:
+        if (Payload_Size >= 3)
+        {
+            printf(" page %u component %u %s", Payload[0], Payload[1], Payload[2] ? "press" : "release");
+        }
+        break;
+    case Nextion_Class::Touch_Coordinate_Awake:
+    case Nextion_Class::Touch_Coordinate_Sleep:
+        if (Payload_Size >= 5)
+        {
+            printf(" x %u y %u %s", (Payload[0] << 8) | Payload[1], (Payload[2] << 8) | Payload[3], Payload[4] ? "press" : "release");
+        }
+        break;
+    default:
+        for (uint16_t i = 0; i < Payload_Size; i++)
+        {
+            printf(" %02X", Payload[i]);
+        }
+        break;
+    }
+    printf("\n");
+}
+
+int main(int Argument_Count, char **Arguments)
+{
+    FILE *File = stdin;
+    if (Argument_Count > 1 && (File = fopen(Arguments[1], "rb")) == NULL)
+    {
+        fprintf(stderr, "Cannot open %s\n", Arguments[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> Blob;
+    if (!Read_Input(File, Blob) || Blob.size() < 8 || Blob[0] != 'N' || Blob[1] != 'X' || Blob[2] != 'T' || Blob[3] != 'R')
+    {
+        fprintf(stderr, "Not a trace\n");
+        return 1;
+    }
+    if (Blob[4] != 1)
+    {
+        fprintf(stderr, "Unsupported trace version %u\n", Blob[4]);
+        return 1;
+    }
+
+    uint8_t Frame_Size = Blob[5];
+    uint16_t Count = Blob[6] | (Blob[7] << 8);
+    size_t Position = 8;
+    uint32_t First_Time = 0, Previous_Time = 0;
+
+    printf("%12s %12s  %-3s  %-12s %s\n", "time (ms)", "delta (ms)", "dir", "name", "frame");
+    for (uint16_t i = 0; i < Count; i++)
+    {
+        if (Position + 7 > Blob.size())
+        {
+            fprintf(stderr, "Truncated trace (%u of %u records)\n", i, Count);
+            return 1;
+        }
+        const uint8_t *Header = &Blob[Position];
+        uint32_t Time = Header[0] | (Header[1] << 8) | (Header[2] << 16) | ((uint32_t)Header[3] << 24);
+        uint16_t Size = Header[4] | (Header[5] << 8);
+        uint8_t Direction = Header[6];
+        uint16_t Recorded_Size = (Size < Frame_Size) ? Size : Frame_Size;
+        Position += 7;
+        if (Position + Recorded_Size > Blob.size())
+        {
+            fprintf(stderr, "Truncated trace (%u of %u records)\n", i, Count);
+            return 1;
+        }
+
+        if (i == 0)
+        {
+            First_Time = Previous_Time = Time;
+        }
+        // -- Unsigned differences : correct across the 32 bits microseconds counter wrap around.
+        printf("%12.3f %12.3f  %-3s  ", (uint32_t)(Time - First_Time) / 1000.0, (uint32_t)(Time - Previous_Time) / 1000.0, (Direction == 0) ? "TX" : "RX");
+        if (Direction == 0)
+        {
+            Print_Transmitted(&Blob[Position], Recorded_Size, Size);
+        }
+        else
+        {
+            Print_Received(&Blob[Position], Recorded_Size, Size);
+        }
+
+        Previous_Time = Time;
+        Position += Recorded_Size;
+    }
+
+    return 0;
+}
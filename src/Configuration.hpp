@@ -1,3 +1,101 @@
 #define Version_Major 1
 #define Version_Minor 0
-#define Version_Revision 0
\ No newline at end of file
+#define Version_Revision 0
+
+// -- Size of the buffer in which instructions are encoded before being written to the UART.
+// -- Longer instructions are written in several chunks.
+#ifndef Nextion_Frame_Buffer_Size
+#define Nextion_Frame_Buffer_Size 256
+#endif
+
+
+// -- Number of bytes of an instruction kept by a shadow cache entry, to compare it with the next one. Longer instructions are always sent.
+#ifndef Nextion_Shadow_Cache_Entry_Size
+#define Nextion_Shadow_Cache_Entry_Size 48
+#endif
+
+// -- Size of the UART transmit buffer (in bytes), so that writes return as soon as the frame is copied instead of waiting for the hardware FIFO.
+// -- At least one upload chunk (4096 bytes), so that Update() reads the next chunk while the whole current one is sent. It also covers the transmit queue of asynchronous transmission.
+#ifndef Nextion_UART_Transmit_Buffer_Size
+#define Nextion_UART_Transmit_Buffer_Size 4096
+#endif
+
+// -- Maximum number of tasks simultaneously waiting for a response from the display.
+#ifndef Nextion_Maximum_Waiters
+#define Nextion_Maximum_Waiters 4
+#endif
+
+// -- Maximum number of acknowledged instructions in flight.
+#ifndef Nextion_Maximum_Window
+#define Nextion_Maximum_Window 16
+#endif
+
+// -- Number of acknowledged instructions whose status can still be queried.
+#ifndef Nextion_Command_History_Size
+#define Nextion_Command_History_Size 32
+#endif
+
+// -- Number of parsed frames whose callbacks can wait to be called (frames parsed while a task waits for a response or an acknowledge).
+#ifndef Nextion_Callback_Queue_Size
+#define Nextion_Callback_Queue_Size 4
+#endif
+
+// -- Time after which an unacknowledged instruction is considered lost (in milliseconds).
+#ifndef Nextion_Acknowledge_Time_Out
+#define Nextion_Acknowledge_Time_Out 500
+#endif
+
+// -- Number of attempts of a resumable update before giving up.
+#ifndef Nextion_Update_Attempts
+#define Nextion_Update_Attempts 3
+#endif
+
+// -- Store the last baud rate the display answered at (in NVS), so that it is tried first by the next discovery.
+#ifndef Nextion_Baud_Rate_Persistence
+#define Nextion_Baud_Rate_Persistence 1
+#endif
+
+// -- Maximum number of waveform streams (component and channel pairs).
+#ifndef Nextion_Maximum_Waveform_Streams
+#define Nextion_Maximum_Waveform_Streams 4
+#endif
+
+// -- Maximum pixel budget of the decimating Add_Value_Waveform() overloads (size of their stack buffer). Larger budgets are reduced to it.
+#ifndef Nextion_Maximum_Waveform_Width
+#define Nextion_Maximum_Waveform_Width 480
+#endif
+
+// -- Maximum size of a transparent data transfer (limited by the display serial buffer).
+#ifndef Nextion_Transparent_Chunk_Size
+#define Nextion_Transparent_Chunk_Size 1024
+#endif
+
+// -- Time to wait for the display to enter or leave transparent mode (in milliseconds).
+#ifndef Nextion_Transparent_Time_Out
+#define Nextion_Transparent_Time_Out 100
+#endif
+
+// -- Maintain the link statistics returned by Get_Statistics() (0 compiles the counters out).
+#ifndef Nextion_Statistics
+#define Nextion_Statistics 1
+#endif
+
+// -- Number of frames kept in the protocol trace (0 compiles the trace out).
+#ifndef Nextion_Trace_Size
+#define Nextion_Trace_Size 32
+#endif
+
+// -- Number of bytes kept for each traced frame (longer frames are truncated).
+#ifndef Nextion_Trace_Frame_Size
+#define Nextion_Trace_Frame_Size 24
+#endif
+
+// -- Number of buckets of the latency histograms (bucket n counts latencies below 2^n microseconds).
+#ifndef Nextion_Statistics_Histogram_Size
+#define Nextion_Statistics_Histogram_Size 20
+#endif
+
+// -- Provide the Arduino String overloads (0 removes them : the library then never allocates a String).
+#ifndef Nextion_String_Overloads
+#define Nextion_String_Overloads 1
+#endif
@@ -0,0 +1,124 @@
+///
+/// @file Nextion_Component.hpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Typed component handles, holding the instruction prefixes of their attributes.
+/// @details The prefixes are built at compile time by string literal concatenation, and a handle declared constexpr lives in flash. An update then copies the prefix and encodes the value, without scanning the object name.
+///     static constexpr Nextion_Number_Class Speed = Nextion_Number("n0");
+///     Display.Set_Value(Speed, 42); // -- n0.val=42
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_COMPONENT_H_INCLUDED
+#define NEXTION_COMPONENT_H_INCLUDED
+
+#include <stdint.h>
+
+typedef struct
+{
+    const char *Data;
+    uint8_t Size;
+} Nextion_Prefix_Type;
+
+// -- Prefix from a string literal (fails to compile above 255 characters).
+#define Nextion_Prefix(Literal) Nextion_Prefix_Type{(Literal), sizeof(Literal) - 1}
+
+///
+/// @brief Component handle, common to every component type.
+///
+class Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Component_Class(Nextion_Prefix_Type Visibility) : Visibility(Visibility)
+    {
+    }
+
+    const Nextion_Prefix_Type Visibility; // -- `vis <name>,`
+};
+
+///
+/// @brief Number component handle.
+///
+class Nextion_Number_Class : public Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Number_Class(Nextion_Prefix_Type Visibility, Nextion_Prefix_Type Value) : Nextion_Component_Class(Visibility),
+                                                                                               Value(Value)
+    {
+    }
+
+    const Nextion_Prefix_Type Value; // -- `<name>.val=`
+};
+
+///
+/// @brief Progress bar component handle.
+///
+class Nextion_Progress_Bar_Class : public Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Progress_Bar_Class(Nextion_Prefix_Type Visibility, Nextion_Prefix_Type Value) : Nextion_Component_Class(Visibility),
+                                                                                                     Value(Value)
+    {
+    }
+
+    const Nextion_Prefix_Type Value; // -- `<name>.val=`
+};
+
+///
+/// @brief Text component handle.
+///
+class Nextion_Text_Class : public Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Text_Class(Nextion_Prefix_Type Visibility, Nextion_Prefix_Type Text, Nextion_Prefix_Type Added_Text) : Nextion_Component_Class(Visibility),
+                                                                                                                            Text(Text),
+                                                                                                                            Added_Text(Added_Text)
+    {
+    }
+
+    const Nextion_Prefix_Type Text;       // -- `<name>.txt="`
+    const Nextion_Prefix_Type Added_Text; // -- `<name>.txt+="`
+};
+
+///
+/// @brief Picture component handle.
+///
+class Nextion_Picture_Class : public Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Picture_Class(Nextion_Prefix_Type Visibility, Nextion_Prefix_Type Picture) : Nextion_Component_Class(Visibility),
+                                                                                                  Picture(Picture)
+    {
+    }
+
+    const Nextion_Prefix_Type Picture; // -- `<name>.pic=`
+};
+
+///
+/// @brief Waveform channel handle.
+///
+class Nextion_Waveform_Class : public Nextion_Component_Class
+{
+public:
+    constexpr Nextion_Waveform_Class(Nextion_Prefix_Type Visibility, Nextion_Prefix_Type Add, Nextion_Prefix_Type Clear, uint8_t Component_ID, uint8_t Channel) : Nextion_Component_Class(Visibility),
+                                                                                                                                                                 Add(Add),
+                                                                                                                                                                 Clear(Clear),
+                                                                                                                                                                 Component_ID(Component_ID),
+                                                                                                                                                                 Channel(Channel)
+    {
+    }
+
+    const Nextion_Prefix_Type Add;   // -- `add <id>,<channel>,`
+    const Nextion_Prefix_Type Clear; // -- `cle <id>,<channel>`
+    const uint8_t Component_ID;
+    const uint8_t Channel;
+};
+
+// -- Handle constructors. Names must be string literals, waveform component ID and channel integer literals.
+#define Nextion_Number(Name) Nextion_Number_Class(Nextion_Prefix("vis " Name ","), Nextion_Prefix(Name ".val="))
+#define Nextion_Progress_Bar(Name) Nextion_Progress_Bar_Class(Nextion_Prefix("vis " Name ","), Nextion_Prefix(Name ".val="))
+#define Nextion_Text(Name) Nextion_Text_Class(Nextion_Prefix("vis " Name ","), Nextion_Prefix(Name ".txt=\""), Nextion_Prefix(Name ".txt+=\""))
+#define Nextion_Picture(Name) Nextion_Picture_Class(Nextion_Prefix("vis " Name ","), Nextion_Prefix(Name ".pic="))
+#define Nextion_Waveform(Name, Component_ID, Channel) Nextion_Waveform_Class(Nextion_Prefix("vis " Name ","), Nextion_Prefix("add " #Component_ID "," #Channel ","), Nextion_Prefix("cle " #Component_ID "," #Channel), Component_ID, Channel)
+
+#endif
@@ -0,0 +1,96 @@
+///
+/// @file Nextion_Decimation.hpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Waveform decimation kernels.
+/// @details Free of Arduino dependencies, so that they can be benchmarked on the host.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_DECIMATION_H_INCLUDED
+#define NEXTION_DECIMATION_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+
+///
+/// @brief Scale and quantize a value to the 0 - 255 range of the waveform instructions.
+///
+template <typename Type>
+inline uint8_t Nextion_Quantize(Type Value, Type Minimum, Type Maximum)
+{
+    if (!(Value > Minimum)) // -- Also catches NaN.
+    {
+        return 0;
+    }
+    if (!(Value < Maximum))
+    {
+        return 255;
+    }
+    return (uint8_t)(((float)Value - (float)Minimum) * 255.0f / ((float)Maximum - (float)Minimum) + 0.5f);
+}
+
+///
+/// @brief Reduce samples to the pixel budget of a waveform, keeping the minimum and the maximum of each bucket so that spikes remain visible.
+/// @details Each bucket of samples produces its minimum and its maximum, in the order they appear. The hot loop is a branchless minimum / maximum reduction the compiler can vectorize (floats require -ffast-math or equivalent).
+///
+/// @param Data Samples.
+/// @param Quantity Number of samples.
+/// @param Output Decimated and quantized samples (at least Width bytes).
+/// @param Width Pixel budget (at least 2).
+/// @param Minimum Value mapped to 0.
+/// @param Maximum Value mapped to 255.
+/// @return Number of samples written to Output.
+template <typename Type>
+uint32_t Nextion_Decimate(const Type *Data, uint32_t Quantity, uint8_t *Output, uint16_t Width, Type Minimum, Type Maximum)
+{
+    if (Quantity <= Width)
+    {
+        for (uint32_t i = 0; i < Quantity; i++)
+        {
+            Output[i] = Nextion_Quantize(Data[i], Minimum, Maximum);
+        }
+        return Quantity;
+    }
+
+    uint32_t Buckets = Width / 2;
+    if (Buckets == 0)
+    {
+        return 0;
+    }
+
+    uint32_t Size = 0;
+    for (uint32_t Bucket = 0; Bucket < Buckets; Bucket++)
+    {
+        const Type *Start = Data + (uint32_t)(((uint64_t)Bucket * Quantity) / Buckets);
+        const Type *End = Data + (uint32_t)(((uint64_t)(Bucket + 1) * Quantity) / Buckets);
+
+        Type Low = *Start;
+        Type High = *Start;
+        for (const Type *Sample = Start + 1; Sample < End; Sample++)
+        {
+            Low = (*Sample < Low) ? *Sample : Low;
+            High = (*Sample > High) ? *Sample : High;
+        }
+
+        // -- Keep the extremes in their order of appearance.
+        const Type *Sample = Start;
+        while (Sample < End - 1 && *Sample != Low && *Sample != High)
+        {
+            Sample++;
+        }
+        if (*Sample == Low)
+        {
+            Output[Size++] = Nextion_Quantize(Low, Minimum, Maximum);
+            Output[Size++] = Nextion_Quantize(High, Minimum, Maximum);
+        }
+        else
+        {
+            Output[Size++] = Nextion_Quantize(High, Minimum, Maximum);
+            Output[Size++] = Nextion_Quantize(Low, Minimum, Maximum);
+        }
+    }
+    return Size;
+}
+
+#endif
@@ -0,0 +1,119 @@
+///
+/// @file Nextion_Encoding.hpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Instruction argument encoding kernels.
+/// @details Free of Arduino dependencies, so that they can be benchmarked on the host.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_ENCODING_H_INCLUDED
+#define NEXTION_ENCODING_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// -- Two digits of each number from 00 to 99.
+static const char Nextion_Digit_Pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+///
+/// @brief Number of decimal digits of a number.
+///
+inline uint8_t Nextion_Count_Digits(uint32_t Number)
+{
+    static const uint32_t Powers[] = {10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    uint8_t Size = 1;
+    while (Size < 10 && Number >= Powers[Size - 1])
+    {
+        Size++;
+    }
+    return Size;
+}
+
+///
+/// @brief Write the decimal digits of a number, two at a time.
+///
+/// @param Number Number to encode.
+/// @param Buffer Output (at least 10 bytes).
+/// @return Number of digits written.
+inline uint8_t Nextion_Encode_Number(uint32_t Number, char *Buffer)
+{
+    uint8_t Size = Nextion_Count_Digits(Number);
+    char *Digit = Buffer + Size;
+    while (Number >= 100)
+    {
+        const char *Pair = Nextion_Digit_Pairs + (Number % 100) * 2;
+        Number /= 100;
+        *--Digit = Pair[1];
+        *--Digit = Pair[0];
+    }
+    if (Number >= 10)
+    {
+        *--Digit = Nextion_Digit_Pairs[Number * 2 + 1];
+        *--Digit = Nextion_Digit_Pairs[Number * 2];
+    }
+    else
+    {
+        *--Digit = '0' + Number;
+    }
+    return Size;
+}
+
+///
+/// @brief Non zero if a word contains a null byte.
+///
+inline uint32_t Nextion_Has_Zero_Byte(uint32_t Word)
+{
+    return (Word - 0x01010101UL) & ~Word & 0x80808080UL;
+}
+
+///
+/// @brief Length of the leading run of a text that needs no escaping (no `"` or `\`).
+/// @details Four bytes are tested at once. Words are read aligned, as the ESP32 does not support unaligned loads.
+///
+/// @param Text Text.
+/// @param Size Size of the text.
+/// @return Number of bytes before the first `"` or `\` (Size if there is none).
+inline size_t Nextion_Escape_Run(const char *Text, size_t Size)
+{
+    const char *Character = Text;
+    const char *End = Text + Size;
+    while (Character < End && ((uintptr_t)Character & 3) != 0)
+    {
+        if (*Character == '\"' || *Character == '\\')
+        {
+            return Character - Text;
+        }
+        Character++;
+    }
+
+    while (End - Character >= (ptrdiff_t)sizeof(uint32_t))
+    {
+        uint32_t Word;
+        memcpy(&Word, Character, sizeof(Word));
+        if (Nextion_Has_Zero_Byte(Word ^ 0x22222222UL) | Nextion_Has_Zero_Byte(Word ^ 0x5C5C5C5CUL))
+        {
+            break;
+        }
+        Character += sizeof(Word);
+    }
+
+    while (Character < End && *Character != '\"' && *Character != '\\')
+    {
+        Character++;
+    }
+    return Character - Text;
+}
+
+#endif
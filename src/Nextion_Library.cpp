@@ -12,10 +12,69 @@
 
 Nextion_Class *Nextion_Class::Instance_Pointer = NULL;
 
-Nextion_Class::Nextion_Class() : Nextion_Serial(1),
+// -- Size of the chunks of the upload protocol.
+static const uint32_t Update_Chunk_Size = 4096;
+
+///
+/// @brief Reverse the order of an array of samples.
+///
+static void Reverse_Samples(uint8_t *Samples, uint16_t Size)
+{
+    for (uint16_t i = 0; i < Size / 2; i++)
+    {
+        uint8_t Sample = Samples[i];
+        Samples[i] = Samples[Size - 1 - i];
+        Samples[Size - 1 - i] = Sample;
+    }
+}
+
+// -- Add a value to a statistics counter.
+#if Nextion_Statistics
+#define Nextion_Count(Counter, Value) (Statistics.Counter += (Value))
+#else
+#define Nextion_Count(Counter, Value)
+#endif
+
+Nextion_Class::Nextion_Class() : Transmit_Ring_Buffer(NULL),
+                                 Transmit_Task_Handle(NULL),
+                                 Flush_Task_Handle(NULL),
+                                 Pending_Frames(0),
+                                 Transmit_Policy(Queue_Block),
+                                 Flushed_Command(0),
+                                 Receive_Task_Handle(NULL),
+                                 Baud_Rate(921600),
+                                 Transport(NULL),
+#ifdef ARDUINO
+                                 Nextion_Serial(1),
+                                 Serial_Transport(Nextion_Serial),
+#endif
                                  Callback_Function_String_Data(Default_Callback_Function_String_Data),
                                  Callback_Function_Numeric_Data(Default_Callback_Function_Numeric_Data),
-                                 Callback_Function_Event(Default_Callback_Function_Event)
+                                 Callback_Function_Event(Default_Callback_Function_Event),
+                                 Callback_Function_Update_Progress(Default_Callback_Function_Update_Progress),
+                                 Batch_Task(NULL),
+                                 Batch_Depth(0),
+                                 Window_Semaphore(NULL),
+                                 Debugging_Level(2),
+                                 Command_Counter(0),
+                                 Last_Command(0),
+                                 Command_Head(0),
+                                 Command_Tail(0),
+                                 Callback_Function_Acknowledge(Default_Callback_Function_Acknowledge),
+                                 Shadow_Cache(NULL),
+                                 Shadow_Cache_Size(0),
+                                 Shadow_Cache_Clock(0),
+                                 Shadow_Cache_Invalidated(false),
+                                 Receive_Position(0),
+                                 Receive_Size(0),
+                                 Callback_Tail(0),
+                                 Callback_Count(0),
+                                 Callback_Task(NULL),
+                                 Parser_State(Parser_Idle),
+                                 Parser_Size(0),
+                                 Parser_Terminator_Count(0),
+                                 Loop_Maximum_Bytes(0),
+                                 Loop_Maximum_Time(0)
 
 {
     if (Instance_Pointer != NULL)
@@ -31,1363 +90,3303 @@ Nextion_Class::Nextion_Class() : Nextion_Serial(1),
         delete this;
     }
     xSemaphoreGive(Serial_Semaphore);
+
+    Receive_Semaphore = xSemaphoreCreateMutex();
+    if (Receive_Semaphore == NULL)
+    {
+        delete this;
+    }
+
     memset(Temporary_String, '\0', sizeof(Temporary_String));
+    memset(Page_History, 0, sizeof(Page_History));
+
+#ifdef ARDUINO
+    Transport = &Serial_Transport;
+#endif
+    memset((void *)Waiters, 0, sizeof(Waiters));
+    memset(Waveform_Streams, 0, sizeof(Waveform_Streams));
+#if Nextion_Statistics
+    memset(&Statistics, 0, sizeof(Statistics));
+    Receive_Overflows_Origin = 0;
+#endif
+#if Nextion_Trace_Size > 0
+    Trace_Head = 0;
+#endif
 }
 
 Nextion_Class::~Nextion_Class()
 {
     if (Instance_Pointer == this)
     {
-        delete Instance_Pointer;
+        Instance_Pointer = NULL;
+    }
+    Set_Receive_Task(false);
+    Set_Acknowledged_Mode(false);
+    Set_Asynchronous_Transmission(false);
+    Set_Shadow_Cache(0);
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+    {
+        delete[] Waveform_Streams[i].Samples;
     }
-    Instance_Pointer = NULL;
+    vSemaphoreDelete(Receive_Semaphore);
     vSemaphoreDelete(Serial_Semaphore);
 }
 
-void Nextion_Class::Begin(uint32_t Baud_Rate, uint8_t RX_Pin, uint8_t TX_Pin)
-{
-    this->Baud_Rate = Baud_Rate;
-    Nextion_Serial.begin(Baud_Rate, SERIAL_8N1, RX_Pin, TX_Pin); //Nextion UART
-    Nextion_Serial.print("DRAKJHSUYDGBNCJHGJKSHBDN");            // exit transparent mode and clear last send command
-    Instruction_End();
-}
-
-void Nextion_Class::Set_Callback_Function_String_Data(void (*Function_Pointer)(const char *, uint8_t))
+///
+/// @brief Start the serial communication with the display.
+/// @details When Discover_Baud_Rate is set, the baud rate the display currently uses is discovered and the display is switched to Baud_Rate.
+///
+/// @param Baud_Rate Baud rate to communicate with.
+/// @param RX_Pin UART RX pin.
+/// @param TX_Pin UART TX pin.
+/// @param Discover_Baud_Rate Discover the baud rate of the display.
+#ifdef ARDUINO
+void Nextion_Class::Begin(uint32_t Baud_Rate, uint8_t RX_Pin, uint8_t TX_Pin, bool Discover_Baud_Rate)
 {
-    Callback_Function_String_Data = Function_Pointer;
+    Serial_Transport.Begin(Baud_Rate, RX_Pin, TX_Pin); //Nextion UART
+    Begin(Serial_Transport, Baud_Rate, Discover_Baud_Rate);
 }
+#endif
 
-void Nextion_Class::Set_Callback_Function_Numeric_Data(void (*Function_Pointer)(uint32_t))
+///
+/// @brief Start the communication with the display over a transport.
+/// @details The transport must already be opened at Baud_Rate. When Discover_Baud_Rate is set, the baud rate the display currently uses is discovered and the display is switched to Baud_Rate.
+///
+/// @param Transport Transport to communicate with.
+/// @param Baud_Rate Baud rate to communicate with.
+/// @param Discover_Baud_Rate Discover the baud rate of the display.
+void Nextion_Class::Begin(Nextion_Transport_Class &Transport, uint32_t Baud_Rate, bool Discover_Baud_Rate)
 {
-    Callback_Function_Numeric_Data = Function_Pointer;
-}
+    this->Transport = &Transport;
+    this->Baud_Rate = Baud_Rate;
+#if Nextion_Statistics
+    Receive_Overflows_Origin = Transport.Get_Overflows();
+#endif
 
-void Nextion_Class::Set_Callback_Function_Event(void (*Function_Pointer)(uint8_t))
-{
-    Callback_Function_Event = Function_Pointer;
-}
+    if (Discover_Baud_Rate)
+    {
+        // -- The discovery reads directly from the UART : prevent the parser from consuming replies.
+        Instruction_Start();
+        xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+        Receive_Position = Receive_Size = 0;
 
-void Nextion_Class::Default_Callback_Function_String_Data(const char *String, uint8_t Size)
-{
-}
+        uint32_t Display_Baud_Rate;
+        if (Connect(Display_Baud_Rate) && Display_Baud_Rate != Baud_Rate)
+        {
+            Instruction_Append(F("baud="));
+            Instruction_Append_Number(Baud_Rate);
+            Instruction_Send();
+            Transport.Flush();
+            vTaskDelay(pdMS_TO_TICKS(50)); // -- Let the display switch.
+            Save_Baud_Rate(Baud_Rate);
+        }
+        Transport.Set_Baud_Rate(Baud_Rate);
 
-void Nextion_Class::Default_Callback_Function_Numeric_Data(uint32_t Numeric_Data)
-{
-}
+        Give_Serial_Semaphore();
+        xSemaphoreGive(Receive_Semaphore);
+    }
 
-void Nextion_Class::Default_Callback_Function_Event(uint8_t Event)
-{
+    Instruction_Start();
+    Frame_Type = Frame_Untracked;
+    Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN")); // exit transparent mode and clear last send command
+    Instruction_End();
 }
 
 ///
-/// @brief Main loop (data parsing etc.).
+/// @brief Enable or disable asynchronous transmission.
+/// @details When enabled, instructions are queued into a ring buffer and written to the UART by a dedicated task, so callers return as soon as the frame is queued.
 ///
-void Nextion_Class::Loop()
+/// @param Enable Enable or disable asynchronous transmission.
+/// @param Queue_Size Size of the transmit ring buffer (in bytes).
+/// @param Policy What to do when the queue is full : block the caller, drop the oldest frames or drop the new one.
+/// @param Priority Priority of the transmit task.
+/// @param Stack_Size Stack size of the transmit task.
+/// @return true if the mode has been changed, false otherwise.
+bool Nextion_Class::Set_Asynchronous_Transmission(bool Enable, size_t Queue_Size, Queue_Policies Policy, UBaseType_t Priority, uint32_t Stack_Size)
 {
-    if (Nextion_Serial.available())
+    Take_Serial_Semaphore();
+
+    if (Transmit_Ring_Buffer != NULL)
     {
+        Flush();
+        vTaskDelete(Transmit_Task_Handle);
+        vRingbufferDelete(Transmit_Ring_Buffer);
+        Transmit_Task_Handle = NULL;
+        Transmit_Ring_Buffer = NULL;
+    }
 
-        Return_Code = Nextion_Serial.read();
-        memset(Temporary_String, '\0', sizeof(Temporary_String));
+    if (Enable == false)
+    {
+        Give_Serial_Semaphore();
+        return true;
+    }
 
-        if (Expected_Event == Return_Code)
-        {
-            State = true;
-        }
+    // -- A queued frame must fit in the ring buffer, along with its headers.
+    if (Queue_Size < (sizeof(Frame_Buffer) + sizeof(Queued_Frame_Header_Type) + 8) * 2)
+    {
+        Queue_Size = (sizeof(Frame_Buffer) + sizeof(Queued_Frame_Header_Type) + 8) * 2;
+    }
 
-        switch (Return_Code)
-        {
-        case Numeric_Data_Enclosed:
+    Transmit_Ring_Buffer = xRingbufferCreate(Queue_Size, RINGBUF_TYPE_NOSPLIT);
+    if (Transmit_Ring_Buffer == NULL)
+    {
+        Give_Serial_Semaphore();
+        return false;
+    }
 
-            Nextion_Serial.readBytes((char *)Temporary_String, 7);
+    Transmit_Policy = Policy;
+    Transmit_Queue_Size = Queue_Size;
+    Transmit_Priority = Priority;
+    Transmit_Stack_Size = Stack_Size;
+    Pending_Frames = 0;
+    Flushed_Command = Command_Counter;
 
-            if (Ending(Temporary_String + 4))
-            {
-                uint32_t Temporary_Long = ((uint32_t)Temporary_String[3] << 24) | ((uint32_t)Temporary_String[2] << 16) | ((uint32_t)Temporary_String[1] << 8) | (Temporary_String[0]);
+    if (xTaskCreatePinnedToCore(Transmit_Task, "Nextion TX", Stack_Size, this, Priority, &Transmit_Task_Handle, tskNO_AFFINITY) != pdPASS)
+    {
+        vRingbufferDelete(Transmit_Ring_Buffer);
+        Transmit_Ring_Buffer = NULL;
+        Transmit_Task_Handle = NULL;
+        Give_Serial_Semaphore();
+        return false;
+    }
 
-                (Callback_Function_Numeric_Data(Temporary_Long));
-            }
+    Give_Serial_Semaphore();
+    return true;
+}
 
-            break;
-        case String_Data_Enclosed:
-            Nextion_Serial.readBytesUntil(0xFF, Temporary_String, sizeof(Temporary_String));
-            Nextion_Serial.read();
-            Nextion_Serial.read();
+///
+/// @brief Start a batch : the instructions issued by the calling task are encoded back to back, and written at once by Commit_Batch().
+/// @details The serial semaphore is held until the commit, so other tasks wait. The batch is also written when the frame buffer is full, and before an instruction whose answer is awaited. Batches can be nested : only the outermost commit writes.
+///
+/// @param Freeze_Refresh Stop the screen refresh during the batch (ref_stop / ref_star), so that the display repaints once.
+void Nextion_Class::Begin_Batch(bool Freeze_Refresh)
+{
+    if (Batch_Task == xTaskGetCurrentTaskHandle())
+    {
+        Batch_Depth++;
+        return;
+    }
 
-            (Callback_Function_String_Data(Temporary_String, sizeof(Temporary_String)));
+    Take_Serial_Semaphore();
+    Batch_Task = xTaskGetCurrentTaskHandle();
+    Batch_Depth = 1;
+    Batch_Refresh = Freeze_Refresh;
+    Frame_Size = 0;
 
-            break;
-        case Current_Page_Number:
-            Nextion_Serial.readBytes((char *)Temporary_String, 4);
-            if (Ending(Temporary_String + 1))
-            {
-                if (Temporary_String[0] != Page_History[0])
-                {
-                    Page_History[4] = Page_History[3];
-                    Page_History[3] = Page_History[2];
-                    Page_History[2] = Page_History[1];
-                    Page_History[1] = Page_History[0];
-                    Page_History[0] = Temporary_String[0];
-                }
+    if (Freeze_Refresh)
+    {
+        Instruction_Start();
+        Instruction_Append(F("ref_stop"));
+        Instruction_End();
+    }
+}
 
-                Callback_Function_Event(Current_Page_Number);
-            }
-            else
-            {
-                Purge();
-            }
-            break;
+///
+/// @brief Write the instructions of the batch in a single call, and release the serial semaphore.
+///
+void Nextion_Class::Commit_Batch()
+{
+    if (Batch_Task != xTaskGetCurrentTaskHandle() || --Batch_Depth != 0)
+    {
+        return;
+    }
 
-        case Touch_Coordinate_Awake:
-        case Touch_Coordinate_Sleep:
-            Nextion_Serial.readBytes((char *)Temporary_String, 5);
-            if (Temporary_String[4] == 01)
-            {
-                X_Press = Temporary_String[0] << 8 | Temporary_String[1];
-                Y_Press = Temporary_String[2] << 8 | Temporary_String[3];
-                Callback_Function_Event(Return_Code);
-            }
-            else if (Temporary_String[4] == 00)
+    if (Batch_Refresh)
+    {
+        Instruction_Start();
+        Instruction_Append(F("ref_star"));
+        Instruction_End();
+    }
+
+    Instruction_Flush();
+    Batch_Task = NULL;
+    xSemaphoreGive(Serial_Semaphore);
+}
+
+///
+/// @brief Wait until every queued frame has been written to the UART.
+///
+/// @param Time_Out Maximum time to wait (in milliseconds).
+/// @return true if the queue is empty, false on timeout.
+bool Nextion_Class::Flush(uint32_t Time_Out)
+{
+    if (Transmit_Ring_Buffer != NULL)
+    {
+        uint32_t Start = millis();
+        Flush_Task_Handle = xTaskGetCurrentTaskHandle();
+        while (Pending_Frames != 0)
+        {
+            if (Time_Out != portMAX_DELAY && (millis() - Start) > Time_Out)
             {
-                X_Release = Temporary_String[0] << 8 | Temporary_String[1];
-                Y_Release = Temporary_String[2] << 8 | Temporary_String[3];
-                Callback_Function_Event(Return_Code);
+                Flush_Task_Handle = NULL;
+                return false;
             }
-            Purge();
-            break;
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        }
+        Flush_Task_Handle = NULL;
+    }
+    Transport->Flush();
+    return true;
+}
 
-        case Touch_Event:
+void Nextion_Class::Transmit_Task(void *Instance)
+{
+    Nextion_Class *Nextion = (Nextion_Class *)Instance;
+    size_t Size;
+    uint8_t *Frame;
 
-            // -- Unhandled yet
-            break;
+    while (1)
+    {
+        Frame = (uint8_t *)xRingbufferReceive(Nextion->Transmit_Ring_Buffer, &Size, portMAX_DELAY);
+        if (Frame == NULL)
+        {
+            continue;
+        }
 
-        // -- 4  bytes instruction
-        case Auto_Entered_Sleep_Mode:
-        case Auto_Wake_From_Sleep_Mode:
-        case Ready:
-        case Start_Upgrade_From_SD:
-        case Transparent_Data_Finished:
-        case Transparent_Data_Ready:
-        case Instruction_Successfull:
-        case Invalid_Component_ID:
-        case Invalid_Page_ID:
-        case Invalid_Picture_ID:
-        case Invalid_Font_ID:
-        case Invalid_CRC:
-        case Invalid_Baud_Rate_Setting:
-        case Invalid_Waveform_ID_Or_Channel:
-        case Invalid_Variable_Name_Or_Attribute:
-        case Invalid_Variable_Operation:
-        case Fail_To_Assign:
-        case Invalid_Quantity_Of_Parameters:
-        case IO_Operation_Failed:
-        case Invalid_Escape_Character:
-        case Too_Long_Variable_Name:
-        case Serial_Buffer_Overflow:
-            Nextion_Serial.readBytes((char *)Temporary_String, 3);
-            if (Ending(Temporary_String))
-            {
-                Callback_Function_Event(Return_Code);
-            }
-            else
+        Nextion->Write_Transport(Frame + sizeof(Queued_Frame_Header_Type), Size - sizeof(Queued_Frame_Header_Type));
+        vRingbufferReturnItem(Nextion->Transmit_Ring_Buffer, Frame);
+
+        if (__atomic_sub_fetch(&Nextion->Pending_Frames, 1, __ATOMIC_SEQ_CST) == 0)
+        {
+            TaskHandle_t Flush_Task = Nextion->Flush_Task_Handle;
+            if (Flush_Task != NULL)
             {
-                Purge();
+                xTaskNotifyGive(Flush_Task);
             }
-            break;
+        }
+    }
+}
 
-        case Invalid_Instruction:
-            switch (Nextion_Serial.read()) //Distinguish Invalid instruction or startup
-            {
-            case 0x00: // Startup Instruction
-                Nextion_Serial.readBytes((char *)Temporary_String, 4);
-                if (Temporary_String[0] == 0x00 && Temporary_String[1] == 0x00 && Temporary_String[2] == 0xFF && Ending(Temporary_String + 3))
-                {
-                    if (Callback_Function_Event != NULL)
-                    {
-                        Callback_Function_Event(Startup);
-                    }
-                }
-                else // unrecognized command : purge serial
-                {
-                    Purge();
-                }
+///
+/// @brief Enable the shadow cache, which suppresses setters that would send the same value again.
+/// @details Entries are keyed by object name and attribute, and evicted in least recently used order. The cache is invalidated when the current page changes and when the display starts up.
+///
+/// @param Size Maximum number of cached attributes (0 disables the cache).
+/// @return true if the cache has been (re)allocated, false otherwise.
+bool Nextion_Class::Set_Shadow_Cache(uint8_t Size)
+{
+    // -- Failed acknowledged instructions evict their entry with the receive semaphore taken.
+    Take_Serial_Semaphore();
+    xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
 
-            case 0xFF: //Invalid Instruction
-                Nextion_Serial.readBytes((char *)Temporary_String, 2);
-                if (Temporary_String[0] == 0xFF && Temporary_String[1] == 0xFF)
-                {
-                    if (Callback_Function_Event != NULL)
-                    {
-                        Callback_Function_Event(Invalid_Instruction);
-                    }
-                }
-                else // Unrecognized instruction : purge serial
-                {
-                    Purge();
-                }
-            }
+    if (Shadow_Cache != NULL)
+    {
+        delete[] Shadow_Cache;
+        Shadow_Cache = NULL;
+        Shadow_Cache_Size = 0;
+    }
 
-        default:
-            Purge();
-            Callback_Function_Event(Return_Code);
-            break;
+    if (Size != 0)
+    {
+        Shadow_Cache = new (std::nothrow) Shadow_Entry_Type[Size];
+        if (Shadow_Cache == NULL)
+        {
+            xSemaphoreGive(Receive_Semaphore);
+            Give_Serial_Semaphore();
+            return false;
         }
+        memset(Shadow_Cache, 0, sizeof(Shadow_Entry_Type) * Size);
+        Shadow_Cache_Size = Size;
     }
+
+    Shadow_Cache_Invalidated = false;
+    xSemaphoreGive(Receive_Semaphore);
+    Give_Serial_Semaphore();
+    return true;
 }
 
-void Nextion_Class::Purge()
+///
+/// @brief Forget every cached attribute, so the next setters are sent regardless of their value.
+///
+void Nextion_Class::Invalidate_Shadow_Cache()
+{
+    // -- The cache is only accessed while holding the serial semaphore : it is cleared by the next cached setter.
+    Shadow_Cache_Invalidated = true;
+}
+
+///
+/// @brief Evict the entry of an attribute the display did not take, so that the next setter sends it again. Called with the receive semaphore taken.
+///
+/// @param Key Hash of the attribute.
+void Nextion_Class::Evict_Shadow_Entry(uint32_t Key)
 {
-    Nextion_Serial.readStringUntil(0xFF);
-    while (Nextion_Serial.peek() == 0xFF)
+    for (uint8_t i = 0; i < Shadow_Cache_Size; i++)
     {
-        Nextion_Serial.read();
+        uint32_t Expected = Key;
+        __atomic_compare_exchange_n(&Shadow_Cache[i].Key, &Expected, (uint32_t)0, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
     }
 }
 
-void Nextion_Class::Write(int Data)
+void Nextion_Class::Set_Callback_Function_String_Data(void (*Function_Pointer)(const char *, uint8_t))
 {
-    Nextion_Serial.write(Data);
+    Callback_Function_String_Data = Function_Pointer;
 }
 
-void Nextion_Class::Send_Raw(const __FlashStringHelper *Data)
+void Nextion_Class::Set_Callback_Function_Numeric_Data(void (*Function_Pointer)(uint32_t))
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Data);
-    Instruction_End();
+    Callback_Function_Numeric_Data = Function_Pointer;
 }
 
-void Nextion_Class::Send_Raw(String const &Data)
+void Nextion_Class::Set_Callback_Function_Event(void (*Function_Pointer)(uint8_t))
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Data);
-    Instruction_End();
+    Callback_Function_Event = Function_Pointer;
 }
 
-void Nextion_Class::Send_Raw(const char *Data)
+void Nextion_Class::Default_Callback_Function_String_Data(const char *String, uint8_t Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Data);
-    Instruction_End();
 }
 
-void Nextion_Class::Refresh(uint16_t Component_ID)
+void Nextion_Class::Default_Callback_Function_Numeric_Data(uint32_t Numeric_Data)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("ref "));
-    Nextion_Serial.print(Component_ID);
-    Instruction_End();
 }
 
-void Nextion_Class::Refresh(const __FlashStringHelper *Object_Name)
+void Nextion_Class::Default_Callback_Function_Event(uint8_t Event)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("ref "));
-    Nextion_Serial.print(Object_Name);
-    Instruction_End();
 }
 
-void Nextion_Class::Refresh(const char *Object_Name)
+void Nextion_Class::Default_Callback_Function_Acknowledge(uint32_t Command, uint8_t Status)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("ref "));
-    Nextion_Serial.print(Object_Name);
-    Instruction_End();
 }
 
-void Nextion_Class::Set_Waveform_Refresh(bool Enable)
+void Nextion_Class::Default_Callback_Function_Update_Progress(uint32_t Sent_Bytes, uint32_t Total_Bytes, uint32_t Bytes_Per_Second)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Enable == true)
-    {
-        Nextion_Serial.print(F("ref_stop"));
-    }
-    else
-    {
-        Nextion_Serial.print(F("ref_star"));
-    }
-    Instruction_End();
 }
 
-uint16_t Nextion_Class::Get_Address()
+void Nextion_Class::Set_Callback_Function_Update_Progress(void (*Function_Pointer)(uint32_t, uint32_t, uint32_t))
 {
-    return Address;
+    Callback_Function_Update_Progress = Function_Pointer;
 }
 
-void Nextion_Class::Set_Address(uint16_t Address)
+void Nextion_Class::Set_Callback_Function_Acknowledge(void (*Function_Pointer)(uint32_t, uint8_t))
 {
-    this->Address = Address;
+    Callback_Function_Acknowledge = Function_Pointer;
 }
 
 ///
-/// @brief Return current displayed page ID.
+/// @brief Make the display acknowledge every instruction (bkcmd=3), and match each reply with the instruction that caused it.
+/// @details Up to Window instructions are sent before the first acknowledge is received. The status of an instruction (Command_Pending, Instruction_Successfull, an error code or Command_Lost) is available through Get_Command_Status() and the acknowledge callback.
 ///
-/// @param Refresh_Now
-/// @return uint8_t
-uint8_t Nextion_Class::Get_Current_Page(bool Refresh_Now)
+/// @param Enable Enable or disable acknowledged mode.
+/// @param Window Maximum number of instructions in flight.
+/// @return true if the mode has been changed, false otherwise.
+bool Nextion_Class::Set_Acknowledged_Mode(bool Enable, uint8_t Window)
 {
-    if (Refresh_Now)
+    if (Window == 0 || Window > Nextion_Maximum_Window)
     {
-        xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-        Nextion_Serial.print(F("sendme"));
-        Instruction_End();
-        Wait_For_Event(Current_Page_Number);
+        return false;
+    }
+    if (Enable == false && Window_Semaphore == NULL)
+    {
+        return true;
     }
-    return Page_History[0];
-}
 
-bool Nextion_Class::Set_Current_Page(uint8_t Page_ID, bool Feedback)
-{
-    for (uint8_t i = 0; i <= 3; i++) // -- Attempts to switch page.
+    // -- Both semaphores are taken : no instruction is being tracked and no reply matched while the window is replaced.
+    Instruction_Start();
+    xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+    if (Window_Semaphore != NULL)
     {
-        DUMP("Set current page");
-        xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-        Nextion_Serial.print(F("page "));
-        Nextion_Serial.print(Page_ID);
-        Instruction_End();
-        if (i >= 3)
-        {
-            DUMP("Failed to set current page.");
-            return false;
-        }
-        if (Get_Current_Page(true) == Page_ID || Feedback == false)
-        {
-            DUMP("Find page.");
-            break;
-        }
-        vTaskDelay(pdMS_TO_TICKS(100));
+        vSemaphoreDelete(Window_Semaphore);
+        Window_Semaphore = NULL;
+    }
+    Command_Head = 0;
+    Command_Tail = 0;
+    for (uint8_t i = 0; i < Nextion_Command_History_Size; i++)
+    {
+        Command_History[i].Status = Command_Unknown;
     }
+    if (Enable)
+    {
+        Window_Semaphore = xSemaphoreCreateCounting(Window, Window);
+    }
+    xSemaphoreGive(Receive_Semaphore);
 
-    return true;
+    // -- The display acknowledges bkcmd=3 itself. Leaving acknowledged mode restores the level set with Set_Debugging().
+    Frame_Type = Enable ? Frame_Command : Frame_Untracked;
+    Instruction_Append(F("bkcmd="));
+    Instruction_Append_Number(Enable ? 3 : Debugging_Level);
+    Instruction_End();
+
+    return (Enable == false || Window_Semaphore != NULL);
 }
 
-bool Nextion_Class::Set_Current_Page(const __FlashStringHelper *Page_Name)
+///
+/// @brief Return the handle of the last instruction sent in acknowledged mode.
+///
+uint32_t Nextion_Class::Get_Last_Command()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("page "));
-    Nextion_Serial.print(Page_Name);
-    Instruction_End();
-    return true;
+    return Last_Command;
 }
 
-void Nextion_Class::Draw_Advanced_Crop_Picture(uint16_t X_Destination, uint16_t Y_Destination, uint16_t Width, uint16_t Height, uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID)
+///
+/// @brief Return the status of an instruction sent in acknowledged mode.
+///
+/// @param Command Handle returned by Get_Last_Command().
+/// @return Command_Pending, Instruction_Successfull, an error code, Command_Lost, Command_Dropped, or Command_Unknown if the instruction is too old.
+uint8_t Nextion_Class::Get_Command_Status(uint32_t Command)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("xpic "));
-    Nextion_Serial.print(X_Destination);
-    Argument_Separator();
-    Nextion_Serial.print(Y_Destination);
-    Argument_Separator();
-    Nextion_Serial.print(Width);
-    Argument_Separator();
-    Nextion_Serial.print(Height);
-    Argument_Separator();
-    Nextion_Serial.print(X_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Picture_ID);
-    Instruction_End();
+    Command_History_Type &Entry = Command_History[Command % Nextion_Command_History_Size];
+    if (Entry.Command != Command)
+    {
+        return Command_Unknown;
+    }
+    return Entry.Status;
+}
+
+///
+/// @brief Parse received data from a dedicated task, woken up by the transport as soon as data is received.
+/// @details Once enabled, Loop() no longer parses data and callbacks are called from the receive task.
+///
+/// @param Enable Enable or disable the receive task.
+/// @param Priority Priority of the receive task.
+/// @param Stack_Size Stack size of the receive task (callbacks run on it).
+/// @param Core Core on which the receive task is pinned (tskNO_AFFINITY for none).
+/// @return true if the mode has been changed, false otherwise.
+bool Nextion_Class::Set_Receive_Task(bool Enable, UBaseType_t Priority, uint32_t Stack_Size, BaseType_t Core)
+{
+    if (Receive_Task_Handle != NULL)
+    {
+        // -- Wait for the current parsing and callback to end : a task deleted in a callback could hold the serial semaphore forever.
+        xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+        while (Callback_Task == Receive_Task_Handle)
+        {
+            xSemaphoreGive(Receive_Semaphore);
+            vTaskDelay(1);
+            xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+        }
+        vTaskDelete(Receive_Task_Handle);
+        Receive_Task_Handle = NULL;
+        xSemaphoreGive(Receive_Semaphore);
+    }
+
+    if (Enable == false)
+    {
+        return true;
+    }
+
+    if (xTaskCreatePinnedToCore(Receive_Task, "Nextion RX", Stack_Size, this, Priority, &Receive_Task_Handle, Core) != pdPASS)
+    {
+        Receive_Task_Handle = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+void Nextion_Class::Receive_Task(void *Instance)
+{
+    Nextion_Class *Nextion = (Nextion_Class *)Instance;
+
+    while (1)
+    {
+        if (!Nextion->Transport->Wait_For_Data(100))
+        {
+            Nextion->Run_Callbacks(); // -- Queued by a task waiting for a response.
+            continue;
+        }
+
+        Nextion->Process(0, 0, portMAX_DELAY);
+    }
+}
+
+///
+/// @brief Limit the work done by each Loop() call.
+///
+/// @param Maximum_Bytes Maximum number of received bytes parsed per call (0 for no limit).
+/// @param Maximum_Time Maximum time spent parsing per call, in microseconds (0 for no limit).
+void Nextion_Class::Set_Loop_Budget(uint16_t Maximum_Bytes, uint32_t Maximum_Time)
+{
+    Loop_Maximum_Bytes = Maximum_Bytes;
+    Loop_Maximum_Time = Maximum_Time;
+}
+
+///
+/// @brief Main loop (data parsing etc.).
+/// @details Parse the received bytes without ever blocking, and dispatch every complete frame. Does nothing when the receive task is enabled.
+///
+void Nextion_Class::Loop()
+{
+    // -- Parse, unless the receive task does it (another task already parsing is not waited for).
+    if (Receive_Task_Handle == NULL)
+    {
+        Process(Loop_Maximum_Bytes, Loop_Maximum_Time, 0);
+    }
+
+    Check_Waveform_Streams();
+}
+
+///
+/// @brief Parse the available received bytes, and call the callback of each frame before parsing the next one.
+/// @details Callbacks are called with no semaphore taken, so they can send instructions (even in acknowledged mode).
+///
+/// @param Maximum_Bytes Maximum number of bytes parsed (0 for no limit).
+/// @param Maximum_Time Maximum time spent parsing, in microseconds (0 for no limit).
+/// @param Time_Out Time to wait for the receive semaphore when another task is parsing.
+void Nextion_Class::Process(uint16_t Maximum_Bytes, uint32_t Maximum_Time, TickType_t Time_Out)
+{
+    uint32_t Start_Time = micros();
+    uint32_t Parsed_Bytes = 0;
+    uint32_t Elapsed_Time;
+
+    while (true)
+    {
+        Elapsed_Time = micros() - Start_Time;
+        if ((Maximum_Bytes != 0 && Parsed_Bytes >= Maximum_Bytes) || (Maximum_Time != 0 && Elapsed_Time >= Maximum_Time) || xSemaphoreTake(Receive_Semaphore, Time_Out) != pdTRUE)
+        {
+            return;
+        }
+        Parsed_Bytes += Receive(Maximum_Bytes ? (Maximum_Bytes - Parsed_Bytes) : 0, Maximum_Time ? (Maximum_Time - Elapsed_Time) : 0, false);
+        xSemaphoreGive(Receive_Semaphore);
+
+        // -- The parser stopped at a frame with a callback, or there is nothing left to parse.
+        if (!Run_Callbacks())
+        {
+            return;
+        }
+    }
+}
+
+///
+/// @brief Parse the available received bytes. Called with the receive semaphore taken.
+///
+/// @param Maximum_Bytes Maximum number of bytes parsed (0 for no limit).
+/// @param Maximum_Time Maximum time spent parsing, in microseconds (0 for no limit).
+/// @param Waiting false to stop at the first frame with a callback, so that it is called before the next frame is parsed. true when called by a task waiting for a response or an acknowledge, which may hold the serial semaphore : callbacks are queued (and dropped if the queue is full).
+/// @return Number of parsed bytes.
+size_t Nextion_Class::Receive(uint16_t Maximum_Bytes, uint32_t Maximum_Time, bool Waiting)
+{
+    uint32_t Start_Time = micros();
+    size_t Parsed_Bytes = 0;
+    size_t Available;
+
+    while (true)
+    {
+        while (Receive_Position < Receive_Size)
+        {
+            if ((!Waiting && Callback_Count != 0) || (Maximum_Bytes != 0 && Parsed_Bytes >= Maximum_Bytes))
+            {
+                return Parsed_Bytes;
+            }
+            Parse(Receive_Buffer[Receive_Position++]);
+            Parsed_Bytes++;
+        }
+
+        if ((Maximum_Time != 0 && (micros() - Start_Time) >= Maximum_Time) || (Available = Transport->Available()) == 0)
+        {
+            return Parsed_Bytes;
+        }
+        if (Available > sizeof(Receive_Buffer))
+        {
+            Available = sizeof(Receive_Buffer);
+        }
+        Receive_Size = Transport->Read(Receive_Buffer, Available);
+        Receive_Position = 0;
+        Nextion_Count(Received_Bytes, Receive_Size);
+        if (Receive_Size == 0)
+        {
+            return Parsed_Bytes;
+        }
+    }
+}
+
+///
+/// @brief Queue the callback of a parsed frame. Called with the receive semaphore taken.
+/// @details The string data is taken from Temporary_String. Callbacks left to their default are not queued.
+///
+/// @param Type Callback_String_Data, Callback_Numeric_Data, Callback_Event or Callback_Acknowledge.
+/// @param Value Numeric data, event or acknowledged instruction.
+/// @param Status Status of the acknowledged instruction.
+void Nextion_Class::Queue_Callback(uint8_t Type, uint32_t Value, uint8_t Status)
+{
+    switch (Type)
+    {
+    case Callback_String_Data:
+        if (Callback_Function_String_Data == Default_Callback_Function_String_Data)
+        {
+            return;
+        }
+        break;
+    case Callback_Numeric_Data:
+        if (Callback_Function_Numeric_Data == Default_Callback_Function_Numeric_Data)
+        {
+            return;
+        }
+        break;
+    case Callback_Event:
+        if (Callback_Function_Event == Default_Callback_Function_Event)
+        {
+            return;
+        }
+        break;
+    default:
+        if (Callback_Function_Acknowledge == Default_Callback_Function_Acknowledge)
+        {
+            return;
+        }
+        break;
+    }
+
+    if (Callback_Count >= Nextion_Callback_Queue_Size)
+    {
+        Nextion_Count(Dropped_Callbacks, 1);
+        return;
+    }
+
+    Callback_Type &Callback = Callbacks[(Callback_Tail + Callback_Count) % Nextion_Callback_Queue_Size];
+    Callback.Type = Type;
+    Callback.Value = Value;
+    Callback.Status = Status;
+    Callback.Size = 0;
+    if (Type == Callback_String_Data)
+    {
+        Callback.Size = Parser_Size;
+        memcpy(Callback.String, Temporary_String, Parser_Size + 1);
+    }
+    Callback_Count++;
+}
+
+///
+/// @brief Call the queued callbacks, in order, with no semaphore taken.
+///
+/// @return true if at least one callback has been called.
+bool Nextion_Class::Run_Callbacks()
+{
+    Callback_Type Callback;
+    bool Called = false;
+
+    while (Callback_Count != 0)
+    {
+        xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+        if (Callback_Count == 0) // -- Called by another task meanwhile.
+        {
+            xSemaphoreGive(Receive_Semaphore);
+            break;
+        }
+        memcpy(&Callback, &Callbacks[Callback_Tail], sizeof(Callback_Type) - sizeof(Callback.String) + Callbacks[Callback_Tail].Size + 1);
+        Callback_Tail = (Callback_Tail + 1) % Nextion_Callback_Queue_Size;
+        Callback_Count--;
+        Callback_Task = xTaskGetCurrentTaskHandle();
+        xSemaphoreGive(Receive_Semaphore);
+
+        switch (Callback.Type)
+        {
+        case Callback_String_Data:
+            Callback_Function_String_Data(Callback.String, Callback.Size);
+            break;
+        case Callback_Numeric_Data:
+            Callback_Function_Numeric_Data(Callback.Value);
+            break;
+        case Callback_Event:
+            Callback_Function_Event(Callback.Value);
+            break;
+        default:
+            Callback_Function_Acknowledge(Callback.Value, Callback.Status);
+            break;
+        }
+        Callback_Task = NULL;
+        Called = true;
+    }
+    return Called;
+}
+
+///
+/// @brief Feed one received byte to the parser state machine.
+///
+void Nextion_Class::Parse(uint8_t Byte)
+{
+    switch (Parser_State)
+    {
+    case Parser_Idle:
+        if (Byte == 0xFF) // -- Remaining of a previous terminator.
+        {
+            break;
+        }
+        Return_Code = Byte;
+        Parser_Size = 0;
+        Parser_Terminator_Count = 0;
+        switch (Return_Code)
+        {
+        case Numeric_Data_Enclosed:
+            Parser_Expected_Size = 4;
+            Parser_State = Parser_Fixed_Payload;
+            break;
+        case Current_Page_Number:
+            Parser_Expected_Size = 1;
+            Parser_State = Parser_Fixed_Payload;
+            break;
+        case Touch_Coordinate_Awake:
+        case Touch_Coordinate_Sleep:
+            Parser_Expected_Size = 5;
+            Parser_State = Parser_Fixed_Payload;
+            break;
+        case Touch_Event:
+            Parser_Expected_Size = 3;
+            Parser_State = Parser_Fixed_Payload;
+            break;
+        // -- 4  bytes instruction
+        case Auto_Entered_Sleep_Mode:
+        case Auto_Wake_From_Sleep_Mode:
+        case Ready:
+        case Start_Upgrade_From_SD:
+        case Transparent_Data_Finished:
+        case Transparent_Data_Ready:
+        case Instruction_Successfull:
+        case Invalid_Component_ID:
+        case Invalid_Page_ID:
+        case Invalid_Picture_ID:
+        case Invalid_Font_ID:
+        case Invalid_File_Operation:
+        case Invalid_CRC:
+        case Invalid_Baud_Rate_Setting:
+        case Invalid_Waveform_ID_Or_Channel:
+        case Invalid_Variable_Name_Or_Attribute:
+        case Invalid_Variable_Operation:
+        case Fail_To_Assign:
+        case Fail_EEPROM_Operation:
+        case Invalid_Quantity_Of_Parameters:
+        case IO_Operation_Failed:
+        case Invalid_Escape_Character:
+        case Too_Long_Variable_Name:
+        case Serial_Buffer_Overflow:
+            Parser_Expected_Size = 0;
+            Parser_State = Parser_Terminator;
+            break;
+        // -- String data, startup / invalid instruction (distinguished by their length) and unknown frames
+        default:
+            Parser_State = Parser_Variable_Payload;
+            break;
+        }
+        break;
+
+    case Parser_Fixed_Payload:
+        Temporary_String[Parser_Size++] = Byte;
+        if (Parser_Size >= Parser_Expected_Size)
+        {
+            Parser_State = Parser_Terminator;
+        }
+        break;
+
+    case Parser_Terminator:
+        if (Byte != 0xFF) // -- Malformed frame : drop it.
+        {
+            Parser_State = Parser_Resynchronize;
+            Parser_Terminator_Count = 0;
+            Nextion_Count(Resynchronizations, 1);
+            break;
+        }
+        if (++Parser_Terminator_Count >= 3)
+        {
+            Parser_State = Parser_Idle;
+            Dispatch();
+        }
+        break;
+
+    case Parser_Variable_Payload:
+        if (Byte == 0xFF)
+        {
+            if (++Parser_Terminator_Count >= 3)
+            {
+                Parser_State = Parser_Idle;
+                Dispatch();
+            }
+            break;
+        }
+        // -- 0xFF bytes not followed by a full terminator were part of the payload.
+        for (; Parser_Terminator_Count > 0; Parser_Terminator_Count--)
+        {
+            if (Parser_Size < (sizeof(Temporary_String) - 1))
+            {
+                Temporary_String[Parser_Size++] = 0xFF;
+            }
+            else
+            {
+                Nextion_Count(Truncated_Bytes, 1);
+            }
+        }
+        if (Parser_Size < (sizeof(Temporary_String) - 1)) // -- Longer payloads are truncated.
+        {
+            Temporary_String[Parser_Size++] = Byte;
+        }
+        else
+        {
+            Nextion_Count(Truncated_Bytes, 1);
+        }
+        break;
+
+    default: // -- Resynchronize : drop everything until the next terminator.
+        if (Byte == 0xFF)
+        {
+            if (++Parser_Terminator_Count >= 3)
+            {
+                Parser_State = Parser_Idle;
+            }
+        }
+        else
+        {
+            Parser_Terminator_Count = 0;
+        }
+        break;
+    }
+}
+
+///
+/// @brief Handle a complete frame (return code in Return_Code, payload in Temporary_String).
+///
+void Nextion_Class::Dispatch()
+{
+    const uint8_t *Payload = (const uint8_t *)Temporary_String;
+    uint8_t Event = Return_Code;
+    Temporary_String[Parser_Size] = '\0';
+    Nextion_Count(Received_Frames, 1);
+
+#if Nextion_Trace_Size > 0
+    // -- The return code, then the payload.
+    Trace_Record_Type &Record = Reserve_Trace_Record(Trace_Receive, Parser_Size + 1);
+    Record.Data[0] = Return_Code;
+    memcpy(Record.Data + 1, Temporary_String, (Parser_Size < sizeof(Record.Data) - 1) ? Parser_Size : sizeof(Record.Data) - 1);
+#endif
+
+    switch (Return_Code)
+    {
+    case Numeric_Data_Enclosed:
+        Acknowledge_Command(Return_Code, Frame_Query);
+        Queue_Callback(Callback_Numeric_Data, ((uint32_t)Payload[3] << 24) | ((uint32_t)Payload[2] << 16) | ((uint32_t)Payload[1] << 8) | Payload[0]);
+        break;
+
+    case String_Data_Enclosed:
+        Acknowledge_Command(Return_Code, Frame_Query);
+        Queue_Callback(Callback_String_Data, 0);
+        break;
+
+    case Current_Page_Number:
+        Acknowledge_Command(Return_Code, Frame_Query);
+        if (Payload[0] != Page_History[0])
+        {
+            Page_Changed(Payload[0]);
+        }
+        Queue_Callback(Callback_Event, Current_Page_Number);
+        break;
+
+    case Touch_Coordinate_Awake:
+    case Touch_Coordinate_Sleep:
+        if (Payload[4] == 01)
+        {
+            X_Press = Payload[0] << 8 | Payload[1];
+            Y_Press = Payload[2] << 8 | Payload[3];
+        }
+        else
+        {
+            X_Release = Payload[0] << 8 | Payload[1];
+            Y_Release = Payload[2] << 8 | Payload[3];
+        }
+        Queue_Callback(Callback_Event, Return_Code);
+        break;
+
+    case Touch_Event:
+        // -- Unhandled yet
+        break;
+
+    case Invalid_Instruction: // -- Also startup, distinguished by its payload
+        if (Parser_Size == 2 && Payload[0] == 0x00 && Payload[1] == 0x00)
+        {
+            Invalidate_Shadow_Cache();
+            Event = Startup;
+            Queue_Callback(Callback_Event, Startup);
+        }
+        else
+        {
+            Nextion_Count(Return_Codes[Invalid_Instruction], 1);
+            Acknowledge_Command(Invalid_Instruction);
+            Queue_Callback(Callback_Event, Invalid_Instruction);
+        }
+        break;
+
+    case Instruction_Successfull:
+    case Invalid_Component_ID:
+    case Invalid_Page_ID:
+    case Invalid_Picture_ID:
+    case Invalid_Font_ID:
+    case Invalid_File_Operation:
+    case Invalid_CRC:
+    case Invalid_Baud_Rate_Setting:
+    case Invalid_Waveform_ID_Or_Channel:
+    case Invalid_Variable_Name_Or_Attribute:
+    case Invalid_Variable_Operation:
+    case Fail_To_Assign:
+    case Fail_EEPROM_Operation:
+    case Invalid_Quantity_Of_Parameters:
+    case IO_Operation_Failed:
+    case Invalid_Escape_Character:
+    case Too_Long_Variable_Name:
+    case Serial_Buffer_Overflow:
+        Nextion_Count(Return_Codes[Return_Code], 1);
+        Acknowledge_Command(Return_Code);
+        Queue_Callback(Callback_Event, Return_Code);
+        break;
+
+    case Transparent_Data_Ready:
+        Acknowledge_Command(Return_Code, Frame_Transparent);
+        Queue_Callback(Callback_Event, Return_Code);
+        break;
+
+    default:
+        Queue_Callback(Callback_Event, Return_Code);
+        break;
+    }
+
+    Notify_Waiters(Event);
+}
+
+///
+/// @brief Reserve a place in the window for the instruction being sent, and record it as in flight.
+/// @details Called with the serial semaphore taken, so the FIFO order is the order on the wire.
+///
+void Nextion_Class::Track_Command(uint32_t Cache_Key)
+{
+    uint32_t Start_Time = millis();
+    // -- Another task parses the acknowledges, unless the instruction is sent by a callback on the receive task.
+    bool Parsed_Elsewhere = (Receive_Task_Handle != NULL && Receive_Task_Handle != xTaskGetCurrentTaskHandle());
+
+    while (xSemaphoreTake(Window_Semaphore, Parsed_Elsewhere ? pdMS_TO_TICKS(10) : 0) != pdTRUE)
+    {
+        // -- In a batch, the instructions holding the window may not be sent yet.
+        if (Batch_Task != NULL)
+        {
+            Instruction_Flush();
+        }
+        // -- Parse here whenever possible : the receive task may itself be blocked by a callback sending an instruction. Callbacks are queued, as the serial semaphore is held.
+        if (xSemaphoreTake(Receive_Semaphore, 0) == pdTRUE)
+        {
+            Receive(0, 0, true);
+            // -- The oldest instruction will never be acknowledged : free its place.
+            if ((millis() - Start_Time) > Nextion_Acknowledge_Time_Out)
+            {
+                Complete_Command(Command_Lost);
+                Start_Time = millis();
+            }
+            xSemaphoreGive(Receive_Semaphore);
+        }
+        if (!Parsed_Elsewhere)
+        {
+            vTaskDelay(1);
+        }
+    }
+
+    // -- Internal frames are numbered like the others (Drop_Frame() finds them), but have no handle.
+    uint32_t Command = ++Command_Counter;
+    if (Frame_Type == Frame_Command || Frame_Type == Frame_Query)
+    {
+        Last_Command = Command;
+        Command_History_Type &Entry = Command_History[Command % Nextion_Command_History_Size];
+        Entry.Command = Command;
+        Entry.Status = Command_Pending;
+    }
+
+    uint8_t Head = Command_Head;
+    Command_FIFO[Head % Nextion_Maximum_Window] = Command;
+    Command_Type[Head % Nextion_Maximum_Window] = Frame_Type;
+    Command_Unsent[Head % Nextion_Maximum_Window] = false;
+    Command_Cache_Key[Head % Nextion_Maximum_Window] = Cache_Key;
+#if Nextion_Statistics
+    Command_Time[Head % Nextion_Maximum_Window] = micros();
+#endif
+    __atomic_store_n(&Command_Head, (uint8_t)(Head + 1), __ATOMIC_SEQ_CST);
+}
+
+///
+/// @brief Match a reply with the oldest instruction in flight.
+///
+/// @param Status Return code of the reply.
+/// @param Reply_Type Frame_Command for 0x01 or an error code, which acknowledge any instruction. Frame_Query for returned data and Frame_Transparent for 0xFE, which only acknowledge this type of instruction.
+void Nextion_Class::Acknowledge_Command(uint8_t Status, uint8_t Reply_Type)
+{
+    if (Window_Semaphore == NULL || Command_Tail == Command_Head)
+    {
+        return;
+    }
+    // -- A reset swallowed as transparent data is not answered : the reply belongs to the next instruction.
+    if (Command_Type[Command_Tail % Nextion_Maximum_Window] == Frame_Reset)
+    {
+        Complete_Command(Status);
+        if ((Reply_Type == Frame_Command && Status == Invalid_Instruction) || Command_Tail == Command_Head)
+        {
+            return;
+        }
+    }
+    if (Reply_Type != Frame_Command && Command_Type[Command_Tail % Nextion_Maximum_Window] != Reply_Type) // -- Not requested by the library (sent by the HMI).
+    {
+        return;
+    }
+    Complete_Command((Reply_Type == Frame_Command) ? Status : (uint8_t)Instruction_Successfull);
+}
+
+///
+/// @brief Remove the oldest instruction in flight and report its status. Called with the receive semaphore taken.
+///
+void Nextion_Class::Complete_Command(uint8_t Status)
+{
+    if (Command_Tail == Command_Head)
+    {
+        return;
+    }
+    uint32_t Command = Command_FIFO[Command_Tail % Nextion_Maximum_Window];
+    // -- The display did not take the value : the next setter must not be suppressed.
+    if (Status != Instruction_Successfull && Command_Cache_Key[Command_Tail % Nextion_Maximum_Window] != 0)
+    {
+        Evict_Shadow_Entry(Command_Cache_Key[Command_Tail % Nextion_Maximum_Window]);
+    }
+#if Nextion_Statistics
+    if (Status == Command_Lost)
+    {
+        Statistics.Time_Outs++;
+    }
+    else if (Status != Command_Dropped)
+    {
+        Record_Latency(Statistics.Acknowledge_Latency, micros() - Command_Time[Command_Tail % Nextion_Maximum_Window]);
+    }
+#endif
+    bool Internal = (Command_Type[Command_Tail % Nextion_Maximum_Window] == Frame_Transparent || Command_Type[Command_Tail % Nextion_Maximum_Window] == Frame_Reset);
+    __atomic_store_n(&Command_Tail, (uint8_t)(Command_Tail + 1), __ATOMIC_SEQ_CST);
+
+    if (!Internal)
+    {
+        Command_History_Type &Entry = Command_History[Command % Nextion_Command_History_Size];
+        if (Entry.Command == Command)
+        {
+            Entry.Status = Status;
+        }
+    }
+    xSemaphoreGive(Window_Semaphore);
+    if (!Internal)
+    {
+        Queue_Callback(Callback_Acknowledge, Command, Status);
+    }
+
+    // -- The next instruction was dropped from the transmit queue : it will never be acknowledged.
+    if (Command_Tail != Command_Head && Command_Unsent[Command_Tail % Nextion_Maximum_Window])
+    {
+        Complete_Command(Command_Dropped);
+    }
+}
+
+///
+/// @brief Reserve a waiter slot for a response, before sending the instruction that causes it.
+///
+/// @param Expected_Event Return code of the expected frame.
+/// @return Waiter slot to pass to Wait_For_Event(), or Nextion_Maximum_Waiters if every slot is used.
+uint8_t Nextion_Class::Register_Waiter(uint8_t Expected_Event)
+{
+    for (uint8_t i = 0; i < Nextion_Maximum_Waiters; i++)
+    {
+        uint8_t Free = Waiter_Free;
+        if (__atomic_compare_exchange_n(&Waiters[i].State, &Free, (uint8_t)Waiter_Claimed, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+        {
+            Waiters[i].Expected_Event = Expected_Event;
+            Waiters[i].Task = xTaskGetCurrentTaskHandle();
+#if Nextion_Statistics
+            Waiters[i].Start_Time = micros();
+#endif
+            __atomic_store_n(&Waiters[i].State, (uint8_t)Waiter_Armed, __ATOMIC_SEQ_CST);
+            return i;
+        }
+    }
+    return Nextion_Maximum_Waiters;
+}
+
+///
+/// @brief Block the calling task until the response registered with Register_Waiter() is received, and release the slot.
+/// @details The task is woken up by the parser as soon as the frame is dispatched. When no other task is parsing, or when the receive task does not make progress, the waiting task parses received data itself, blocked on the transport between receptions, and only queues the callbacks.
+///
+/// @param Waiter Slot returned by Register_Waiter().
+/// @param Time_Out Maximum time to wait (in milliseconds).
+/// @return true if the response was received, false on timeout.
+bool Nextion_Class::Wait_For_Event(uint8_t Waiter, uint32_t Time_Out)
+{
+    if (Waiter >= Nextion_Maximum_Waiters)
+    {
+        return false;
+    }
+
+    uint32_t Start_Time = millis();
+    uint32_t Elapsed_Time;
+    // -- Parse here when no other task does, or once the receive task seems stuck : it may be blocked by a callback waiting for the serial semaphore held by the caller.
+    bool Parsed_Elsewhere = (Receive_Task_Handle != NULL && Receive_Task_Handle != xTaskGetCurrentTaskHandle());
+    bool Parsing = !Parsed_Elsewhere;
+
+    while (Waiters[Waiter].State != Waiter_Received)
+    {
+        Elapsed_Time = millis() - Start_Time;
+        if (Elapsed_Time >= Time_Out)
+        {
+            break;
+        }
+
+        // -- The serial semaphore may be held : callbacks are queued.
+        if (Parsing && xSemaphoreTake(Receive_Semaphore, 0) == pdTRUE)
+        {
+            Receive(0, 0, true);
+            // -- No other task can take the response while the receive semaphore is held : sleep until data is received.
+            if (Waiters[Waiter].State != Waiter_Received)
+            {
+                Transport->Wait_For_Data(Time_Out - Elapsed_Time);
+            }
+            xSemaphoreGive(Receive_Semaphore);
+            continue;
+        }
+        // -- Another task is parsing : it wakes this one up once the response is dispatched.
+        if (Waiters[Waiter].State != Waiter_Received)
+        {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            Parsing = true;
+        }
+    }
+
+    bool Received = (Waiters[Waiter].State == Waiter_Received);
+#if Nextion_Statistics
+    if (!Received)
+    {
+        Statistics.Time_Outs++;
+    }
+    else if (Waiters[Waiter].Expected_Event == Transparent_Data_Ready || Waiters[Waiter].Expected_Event == Transparent_Data_Finished)
+    {
+        Record_Latency(Statistics.Transparent_Latency, micros() - Waiters[Waiter].Start_Time);
+    }
+    else
+    {
+        Record_Latency(Statistics.Request_Latency, micros() - Waiters[Waiter].Start_Time);
+    }
+#endif
+    __atomic_store_n(&Waiters[Waiter].State, (uint8_t)Waiter_Free, __ATOMIC_SEQ_CST);
+    return Received;
+}
+
+///
+/// @brief Wake up every task waiting for this event.
+///
+void Nextion_Class::Notify_Waiters(uint8_t Event)
+{
+    for (uint8_t i = 0; i < Nextion_Maximum_Waiters; i++)
+    {
+        if (Waiters[i].State == Waiter_Armed && Waiters[i].Expected_Event == Event)
+        {
+            uint8_t Armed = Waiter_Armed;
+            if (__atomic_compare_exchange_n(&Waiters[i].State, &Armed, (uint8_t)Waiter_Received, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            {
+                xTaskNotifyGive(Waiters[i].Task);
+            }
+        }
+    }
+}
+
+///
+/// @brief Drop received data until the next instruction terminator.
+///
+void Nextion_Class::Purge()
+{
+    Parser_State = Parser_Resynchronize;
+    Parser_Terminator_Count = 0;
+    Nextion_Count(Resynchronizations, 1);
+}
+
+///
+/// @brief Write data to the transport, counting and tracing it.
+///
+void Nextion_Class::Write_Transport(const uint8_t *Data, size_t Size)
+{
+    Transport->Write(Data, Size);
+    Nextion_Count(Sent_Bytes, Size);
+#if Nextion_Trace_Size > 0
+    Trace_Record_Type &Record = Reserve_Trace_Record(Trace_Transmit, Size);
+    memcpy(Record.Data, Data, (Size < sizeof(Record.Data)) ? Size : sizeof(Record.Data));
+#endif
+}
+
+///
+/// @brief Write the frame content to the UART in a single call, or queue it when asynchronous transmission is enabled.
+///
+/// @return true if the frame has been written or queued, false if a frame has been dropped by the queue policy (this one with Queue_Fail, older ones with Queue_Drop_Oldest).
+bool Nextion_Class::Instruction_Flush()
+{
+    if (Frame_Size == 0)
+    {
+        return true;
+    }
+
+    if (Transmit_Ring_Buffer == NULL)
+    {
+        Write_Transport(Frame_Buffer, Frame_Size);
+        Frame_Size = 0;
+        Flushed_Command = Command_Counter;
+        return true;
+    }
+
+    Queued_Frame_Header_Type Header = {Flushed_Command + 1, Command_Counter - Flushed_Command};
+    Flushed_Command = Command_Counter;
+    size_t Size = sizeof(Header) + Frame_Size;
+    uint8_t *Item = NULL;
+    bool Queued = true;
+
+    __atomic_add_fetch(&Pending_Frames, 1, __ATOMIC_SEQ_CST);
+
+    switch (Transmit_Policy)
+    {
+    case Queue_Drop_Oldest:
+        while (xRingbufferSendAcquire(Transmit_Ring_Buffer, (void **)&Item, Size, 0) != pdTRUE)
+        {
+            size_t Oldest_Size;
+            Queued_Frame_Header_Type *Oldest_Frame = (Queued_Frame_Header_Type *)xRingbufferReceive(Transmit_Ring_Buffer, &Oldest_Size, 0);
+            if (Oldest_Frame == NULL)
+            {
+                // -- The transmit task holds the only queued frame : let it complete.
+                vTaskDelay(1);
+                continue;
+            }
+            Drop_Frame(*Oldest_Frame);
+            vRingbufferReturnItem(Transmit_Ring_Buffer, Oldest_Frame);
+            __atomic_sub_fetch(&Pending_Frames, 1, __ATOMIC_SEQ_CST);
+            Queued = false;
+        }
+        break;
+    case Queue_Fail:
+        if (xRingbufferSendAcquire(Transmit_Ring_Buffer, (void **)&Item, Size, 0) != pdTRUE)
+        {
+            Drop_Frame(Header);
+            __atomic_sub_fetch(&Pending_Frames, 1, __ATOMIC_SEQ_CST);
+            Frame_Size = 0;
+            return false;
+        }
+        break;
+    default:
+        xRingbufferSendAcquire(Transmit_Ring_Buffer, (void **)&Item, Size, portMAX_DELAY);
+        break;
+    }
+
+    memcpy(Item, &Header, sizeof(Header));
+    memcpy(Item + sizeof(Header), Frame_Buffer, Frame_Size);
+    xRingbufferSendComplete(Transmit_Ring_Buffer, Item);
+
+    Frame_Size = 0;
+    return Queued;
 }
 
-void Nextion_Class::Draw_Fill(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Color)
+///
+/// @brief Account for a frame dropped from the transmit queue.
+/// @details Its acknowledged instructions will never be acknowledged : they are reported as Command_Dropped and leave the window, so that the next replies are matched with the right instructions. The shadow cache may hold values that never reached the display : it is invalidated.
+///
+void Nextion_Class::Drop_Frame(Queued_Frame_Header_Type const &Header)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("fill"));
-    Nextion_Serial.print(X_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Width);
-    Argument_Separator();
-    Nextion_Serial.print(Height);
-    Argument_Separator();
-    Nextion_Serial.print(Color);
-    Instruction_End();
+    Nextion_Count(Dropped_Frames, 1);
+    Invalidate_Shadow_Cache();
+
+    if (Window_Semaphore == NULL || Header.Commands == 0)
+    {
+        return;
+    }
+
+    xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+    for (uint8_t i = Command_Tail; i != Command_Head; i++)
+    {
+        if ((uint32_t)(Command_FIFO[i % Nextion_Maximum_Window] - Header.First_Command) < Header.Commands)
+        {
+            Command_Unsent[i % Nextion_Maximum_Window] = true;
+        }
+    }
+    if (Command_Tail != Command_Head && Command_Unsent[Command_Tail % Nextion_Maximum_Window])
+    {
+        Complete_Command(Command_Dropped);
+    }
+    xSemaphoreGive(Receive_Semaphore);
 }
 
-void Nextion_Class::Set_Background_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type)
+///
+/// @brief Terminate and send the frame, unless the shadow cache holds the same value for this attribute.
+///
+/// @param Key_Size Size of the instruction part identifying the attribute (object name, attribute and `=`).
+void Nextion_Class::Instruction_End_Cached(uint16_t Key_Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".bco"));
-    if (Type != -1)
+    if (Shadow_Cache == NULL || Frame_Chunked)
+    {
+        Instruction_End();
+        return;
+    }
+
+    if (Shadow_Cache_Invalidated)
     {
-        Nextion_Serial.print(Type);
+        memset(Shadow_Cache, 0, sizeof(Shadow_Entry_Type) * Shadow_Cache_Size);
+        Shadow_Cache_Invalidated = false;
     }
-    Nextion_Serial.print(F("="));
-    Nextion_Serial.print(Color);
-    Instruction_End();
+
+    const uint8_t *Instruction = Frame_Buffer + Instruction_Offset;
+    uint16_t Size = Frame_Size - Instruction_Offset;
+
+    // -- FNV-1a hash of the attribute, to find its entry quickly.
+    uint32_t Key = 2166136261UL;
+    for (uint16_t i = 0; i < Key_Size; i++)
+    {
+        Key = (Key ^ Instruction[i]) * 16777619UL;
+    }
+    if (Key == 0) // -- 0 marks a free entry.
+    {
+        Key = 1;
+    }
+
+    Shadow_Cache_Clock++;
+    Shadow_Entry_Type *Entry = Shadow_Cache;
+    bool Found = false;
+    for (uint8_t i = 0; i < Shadow_Cache_Size; i++)
+    {
+        if (Shadow_Cache[i].Key == Key && Shadow_Cache[i].Key_Size == Key_Size && memcmp(Shadow_Cache[i].Instruction, Instruction, Key_Size) == 0)
+        {
+            Entry = &Shadow_Cache[i];
+            Found = true;
+            break;
+        }
+        if (Shadow_Cache[i].Last_Use < Entry->Last_Use)
+        {
+            Entry = &Shadow_Cache[i];
+        }
+    }
+
+    if (Found && Entry->Size == Size && memcmp(Entry->Instruction + Key_Size, Instruction + Key_Size, Size - Key_Size) == 0)
+    {
+        Entry->Last_Use = Shadow_Cache_Clock;
+        Frame_Size = Instruction_Offset;
+        Give_Serial_Semaphore();
+        return;
+    }
+
+    // -- The entry is free until the new value is sent : a dropped or failed instruction must not suppress the next one.
+    bool Cached = (Size <= sizeof(Entry->Instruction));
+    __atomic_store_n(&Entry->Key, (uint32_t)0, __ATOMIC_SEQ_CST);
+    if (Cached)
+    {
+        Entry->Key_Size = Key_Size;
+        Entry->Size = Size;
+        Entry->Last_Use = Shadow_Cache_Clock;
+        memcpy(Entry->Instruction, Instruction, Size);
+    }
+
+    bool Sent = true;
+    if (Window_Semaphore != NULL && Frame_Type != Frame_Untracked)
+    {
+        Track_Command(Cached ? Key : 0);
+    }
+    Instruction_Terminate();
+    if (Batch_Task == NULL)
+    {
+        Sent = Instruction_Flush();
+    }
+    if (Cached && Sent)
+    {
+        __atomic_store_n(&Entry->Key, Key, __ATOMIC_SEQ_CST);
+    }
+    Give_Serial_Semaphore();
 }
 
-void Nextion_Class::Set_Time(const __FlashStringHelper *Object_Name, uint16_t Time)
+void Nextion_Class::Instruction_Append(const char *Text)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Time < 50)
+    Instruction_Append((const uint8_t *)Text, strlen(Text));
+}
+
+void Nextion_Class::Instruction_Append(const uint8_t *Data, size_t Size)
+{
+    while (Size != 0)
     {
-        return;
+        if (Frame_Size >= sizeof(Frame_Buffer))
+        {
+            Frame_Chunked = true;
+            Instruction_Flush();
+        }
+        size_t Chunk_Size = sizeof(Frame_Buffer) - Frame_Size;
+        if (Chunk_Size > Size)
+        {
+            Chunk_Size = Size;
+        }
+        memcpy(Frame_Buffer + Frame_Size, Data, Chunk_Size);
+        Frame_Size += Chunk_Size;
+        Data += Chunk_Size;
+        Size -= Chunk_Size;
     }
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".tim="));
-    Nextion_Serial.print(Time);
-    Instruction_End();
 }
 
-void Nextion_Class::Set_Reparse_Mode(uint8_t Mode)
+void Nextion_Class::Instruction_Append_Number(uint32_t Number)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Mode == 0)
+    if (sizeof(Frame_Buffer) - Frame_Size >= 10)
     {
-        Nextion_Serial.print(F("DRAKJHSUYDGBNCJHGJKSHBDN"));
+        Frame_Size += Nextion_Encode_Number(Number, (char *)Frame_Buffer + Frame_Size);
     }
     else
     {
-        Nextion_Serial.print(F("recmod=0"));
+        char Digits[10];
+        Instruction_Append((const uint8_t *)Digits, Nextion_Encode_Number(Number, Digits));
     }
-    Instruction_End();
 }
 
-void Nextion_Class::Set_Trigger(const __FlashStringHelper *Object_Name, bool Enable)
+void Nextion_Class::Instruction_Append_Signed_Number(int32_t Number)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".en="));
-    Nextion_Serial.print(Enable);
-    Instruction_End();
+    if (Number < 0)
+    {
+        Instruction_Append('-');
+        Instruction_Append_Number((uint32_t)(-(int64_t)Number));
+    }
+    else
+    {
+        Instruction_Append_Number((uint32_t)Number);
+    }
 }
 
-void Nextion_Class::Set_Picture(const __FlashStringHelper *Object_Name, uint8_t Picture_ID)
+///
+/// @brief Append a text argument, escaping quotes and backslashes.
+///
+void Nextion_Class::Instruction_Append_Escaped(const char *Text, size_t Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".pic="));
-    Nextion_Serial.print(Picture_ID);
-    Instruction_End();
+    while (true)
+    {
+        // -- Copy the run that needs no escaping at once.
+        size_t Run = Nextion_Escape_Run(Text, Size);
+        Instruction_Append((const uint8_t *)Text, Run);
+        Text += Run;
+        Size -= Run;
+        if (Size == 0)
+        {
+            return;
+        }
+        Instruction_Append('\\');
+        Instruction_Append(*Text);
+        Text++;
+        Size--;
+    }
 }
 
-void Nextion_Class::Set_Picture(String const &Object_Name, uint8_t Picture_ID)
+///
+/// @brief Append a formatted text argument, printed straight into the frame and escaped in place.
+/// @details The escaped text is truncated to the frame buffer size.
+///
+/// @return true if the whole text fits, false if it has been truncated.
+bool Nextion_Class::Instruction_Append_Format(const char *Format, va_list Arguments)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".pic="));
-    Nextion_Serial.print(Picture_ID);
-    Instruction_End();
+    va_list Arguments_Copy;
+    va_copy(Arguments_Copy, Arguments);
+    int Size = vsnprintf((char *)Frame_Buffer + Frame_Size, sizeof(Frame_Buffer) - Frame_Size, Format, Arguments);
+    if (Size < 0)
+    {
+        Size = 0;
+    }
+    else if ((size_t)Size >= sizeof(Frame_Buffer) - Frame_Size && Frame_Size > 0)
+    {
+        // -- Send the beginning of the instruction to make room for the text.
+        Frame_Chunked = true;
+        Instruction_Flush();
+        Size = vsnprintf((char *)Frame_Buffer, sizeof(Frame_Buffer), Format, Arguments_Copy);
+    }
+    va_end(Arguments_Copy);
+    int Formatted_Size = Size;
+    if ((size_t)Size >= sizeof(Frame_Buffer) - Frame_Size)
+    {
+        Size = sizeof(Frame_Buffer) - Frame_Size - 1;
+    }
+
+    // -- Escape in place, from the end, dropping the characters that no longer fit.
+    uint8_t *Text = Frame_Buffer + Frame_Size;
+    size_t Escaped_Size = 0;
+    int Fitting_Size = 0;
+    while (Fitting_Size < Size)
+    {
+        size_t Character_Size = (Text[Fitting_Size] == '\"' || Text[Fitting_Size] == '\\') ? 2 : 1;
+        if (Frame_Size + Escaped_Size + Character_Size > sizeof(Frame_Buffer))
+        {
+            break;
+        }
+        Escaped_Size += Character_Size;
+        Fitting_Size++;
+    }
+    uint8_t *Destination = Text + Escaped_Size;
+    for (int i = Fitting_Size - 1; i >= 0; i--)
+    {
+        *--Destination = Text[i];
+        if (Text[i] == '\"' || Text[i] == '\\')
+        {
+            *--Destination = '\\';
+        }
+    }
+    Frame_Size += Escaped_Size;
+    return Fitting_Size == Formatted_Size;
 }
 
-void Nextion_Class::Set_Font_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type)
+void Nextion_Class::Write(int Data)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".pco"));
-    if (Type != -1)
+    uint8_t Byte = Data;
+    // -- The byte goes after the batched and queued frames, not in the middle of them.
+    Take_Serial_Semaphore();
+    Instruction_Flush();
+    if (Transmit_Ring_Buffer != NULL)
     {
-        Nextion_Serial.print(Type);
+        Flush();
     }
-    Nextion_Serial.print(F("="));
-    Nextion_Serial.print(Color);
-    Instruction_End();
+    Write_Transport(&Byte, 1);
+    Give_Serial_Semaphore();
 }
 
-void Nextion_Class::Set_Horizontal_Font_Spacing(uint16_t Spacing)
+void Nextion_Class::Send_Raw(const char *Data, size_t Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("spax="));
-    Nextion_Serial.print(Spacing);
+    Instruction_Start();
+    Instruction_Append((const uint8_t *)Data, Size);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Vertical_Font_Spacing(uint16_t Spacing)
+void Nextion_Class::Refresh(uint16_t Component_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("spay="));
-    Nextion_Serial.print(Spacing);
+    Instruction_Start();
+    Instruction_Append(F("ref "));
+    Instruction_Append_Number(Component_ID);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Mask(const __FlashStringHelper *Object_Name, bool Masked)
+void Nextion_Class::Refresh(const char *Object_Name)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".pw="));
-    Nextion_Serial.write(Masked);
+    Instruction_Start();
+    Instruction_Append(F("ref "));
+    Instruction_Append(Object_Name);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, char Value)
+void Nextion_Class::Set_Waveform_Refresh(bool Enable)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt=\""));
-    switch (Value)
+    Instruction_Start();
+    if (Enable == true)
     {
-    case '\"':
-        Nextion_Serial.write('\\');
-        Nextion_Serial.write('\"');
-        break;
-    case '\\':
-        Nextion_Serial.write('\\');
-        Nextion_Serial.write('\\');
-        break;
-    case '\0':
-        break;
-    default:
-        Nextion_Serial.write(Value);
-        break;
+        Instruction_Append(F("ref_stop"));
+    }
+    else
+    {
+        Instruction_Append(F("ref_star"));
     }
-    Nextion_Serial.print('\"');
     Instruction_End();
 }
 
-void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, const __FlashStringHelper *Value)
+uint16_t Nextion_Class::Get_Address()
+{
+    return Address;
+}
+
+void Nextion_Class::Set_Address(uint16_t Address)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt=\""));
-    Nextion_Serial.print(Value);
-    Nextion_Serial.print('\"');
-    Instruction_End();
+    this->Address = Address;
 }
 
-void Nextion_Class::Set_Text(String const &Object_Name, String const &Value)
+///
+/// @brief Return current displayed page ID.
+///
+/// @param Refresh_Now
+/// @return uint8_t
+uint8_t Nextion_Class::Get_Current_Page(bool Refresh_Now)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt=\""));
-    Nextion_Serial.print(Value);
-    Nextion_Serial.print('\"');
-    Instruction_End();
+    if (Refresh_Now)
+    {
+        uint8_t Waiter = Register_Waiter(Current_Page_Number);
+        Instruction_Start();
+        Frame_Type = Frame_Query;
+        Instruction_Append(F("sendme"));
+        Instruction_End();
+        Wait_For_Event(Waiter);
+    }
+    return Page_History[0];
 }
 
-void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, const char *Value)
+bool Nextion_Class::Set_Current_Page(uint8_t Page_ID, bool Feedback)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt=\""));
-    uint16_t i = 0;
-    while (1)
+    for (uint8_t i = 0; i <= 3; i++) // -- Attempts to switch page.
     {
-        switch (Value[i])
+        Invalidate_Shadow_Cache();
+        Instruction_Start();
+        Instruction_Append(F("page "));
+        Instruction_Append_Number(Page_ID);
+        Instruction_End();
+        if (i >= 3)
+        {
+            return false;
+        }
+        if (Get_Current_Page(true) == Page_ID || Feedback == false)
         {
-        case '\"':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\"');
-            break;
-        case '\\':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\\');
-            break;
-        case '\0':
-            Nextion_Serial.write('\"');
-            Instruction_End();
-            return;
-        default:
-            Nextion_Serial.write(Value[i]);
             break;
         }
-        i++;
+        vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    if (Page_History[0] != Page_ID) // -- The display did not report the page change.
+    {
+        Page_Changed(Page_ID);
     }
+    Check_Waveform_Streams(); // -- Backfill the waveforms of the new page.
+    return true;
 }
 
-void Nextion_Class::Set_Text(const char *Object_Name, const char *Value)
+///
+/// @brief Record a page change : the shadow cache is invalidated and the waveform streams of the new page are marked for backfill.
+///
+void Nextion_Class::Page_Changed(uint8_t Page_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt=\""));
-    uint16_t i = 0;
-    while (1)
+    Invalidate_Shadow_Cache();
+    Page_History[4] = Page_History[3];
+    Page_History[3] = Page_History[2];
+    Page_History[2] = Page_History[1];
+    Page_History[1] = Page_History[0];
+    Page_History[0] = Page_ID;
+
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
     {
-        switch (Value[i])
+        if (Waveform_Streams[i].Samples != NULL && Waveform_Streams[i].Page_ID == Page_ID)
         {
-        case '\"':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\"');
-            break;
-        case '\\':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\\');
-            break;
-        case '\0':
-            Nextion_Serial.write('\"');
-            Instruction_End();
-            return;
-        default:
-            Nextion_Serial.write(Value[i]);
-            break;
+            Waveform_Streams[i].Backfill = true;
         }
-        i++;
     }
 }
 
-void Nextion_Class::Add_Text(const __FlashStringHelper *Component_Name, const char *Data)
+bool Nextion_Class::Set_Current_Page(const __FlashStringHelper *Page_Name)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Component_Name);
-    Nextion_Serial.print(F(".txt+=\""));
-    uint16_t i = 0;
-    while (1)
+    Invalidate_Shadow_Cache();
+    Instruction_Start();
+    Instruction_Append(F("page "));
+    Instruction_Append(Page_Name);
+    Instruction_End();
+    return true;
+}
+
+void Nextion_Class::Draw_Advanced_Crop_Picture(uint16_t X_Destination, uint16_t Y_Destination, uint16_t Width, uint16_t Height, uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID)
+{
+    Instruction_Start();
+    Instruction_Append(F("xpic "));
+    Instruction_Append_Number(X_Destination);
+    Argument_Separator();
+    Instruction_Append_Number(Y_Destination);
+    Argument_Separator();
+    Instruction_Append_Number(Width);
+    Argument_Separator();
+    Instruction_Append_Number(Height);
+    Argument_Separator();
+    Instruction_Append_Number(X_Coordinate);
+    Argument_Separator();
+    Instruction_Append_Number(Y_Coordinate);
+    Argument_Separator();
+    Instruction_Append_Number(Picture_ID);
+    Instruction_End();
+}
+
+void Nextion_Class::Draw_Fill(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Color)
+{
+    Instruction_Start();
+    Instruction_Append(F("fill "));
+    Instruction_Append_Number(X_Coordinate);
+    Argument_Separator();
+    Instruction_Append_Number(Y_Coordinate);
+    Argument_Separator();
+    Instruction_Append_Number(Width);
+    Argument_Separator();
+    Instruction_Append_Number(Height);
+    Argument_Separator();
+    Instruction_Append_Number(Color);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Background_Color(const char *Object_Name, uint16_t Color, int8_t Type)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".bco"));
+    if (Type != -1)
     {
-        switch (Data[i])
-        {
-        case '\"':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\"');
-            break;
-        case '\\':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\\');
-            break;
-        case '\0':
-            Nextion_Serial.print('\"');
-            Instruction_End();
-            return;
-        default:
-            Nextion_Serial.write(Data[i]);
-            break;
-        }
-        i++;
+        Instruction_Append_Signed_Number(Type);
+    }
+    Instruction_Append(F("="));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    Instruction_Append_Number(Color);
+    Instruction_End_Cached(Key_Size);
+}
+
+void Nextion_Class::Set_Time(const char *Object_Name, uint16_t Time)
+{
+    if (Time < 50)
+    {
+        return;
+    }
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".tim="));
+    Instruction_Append_Number(Time);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Reparse_Mode(uint8_t Mode)
+{
+    Instruction_Start();
+    if (Mode == 0)
+    {
+        Frame_Type = Frame_Reset;
+        Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN"));
     }
+    else
+    {
+        Instruction_Append(F("recmod=0"));
+    }
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Trigger(const char *Object_Name, bool Enable)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".en="));
+    Instruction_Append_Number(Enable);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Picture(const char *Object_Name, uint8_t Picture_ID)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".pic="));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    Instruction_Append_Number(Picture_ID);
+    Instruction_End_Cached(Key_Size);
+}
+
+void Nextion_Class::Set_Font_Color(const char *Object_Name, uint16_t Color, int8_t Type)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".pco"));
+    if (Type != -1)
+    {
+        Instruction_Append_Signed_Number(Type);
+    }
+    Instruction_Append(F("="));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    Instruction_Append_Number(Color);
+    Instruction_End_Cached(Key_Size);
+}
+
+void Nextion_Class::Set_Horizontal_Font_Spacing(uint16_t Spacing)
+{
+    Instruction_Start();
+    Instruction_Append(F("spax="));
+    Instruction_Append_Number(Spacing);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Vertical_Font_Spacing(uint16_t Spacing)
+{
+    Instruction_Start();
+    Instruction_Append(F("spay="));
+    Instruction_Append_Number(Spacing);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Mask(const char *Object_Name, bool Masked)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".pw="));
+    Instruction_Append_Number(Masked);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Text(const char *Object_Name, const char *Value, size_t Size)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".txt=\""));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    Instruction_Append_Escaped(Value, Size);
+    Instruction_Append('\"');
+    Instruction_End_Cached(Key_Size);
 }
 
-void Nextion_Class::Add_Text(const __FlashStringHelper *Object_Name, char Value)
+///
+/// @brief Set the text of a component, formatted printf style straight into the instruction frame (nothing is allocated).
+/// @details The formatted text is limited to the frame buffer : Nextion_Frame_Buffer_Size - 1 bytes once escaped. Longer texts are truncated (use Set_Text() for them).
+///
+/// @param Object_Name Component name.
+/// @param Format printf format.
+/// @return true if the whole text has been sent, false if it has been truncated.
+bool Nextion_Class::Set_Text_Format(const char *Object_Name, const char *Format, ...)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".txt+=\""));
-    switch (Value)
-    {
-    case '\"':
-        Nextion_Serial.write('\\');
-        Nextion_Serial.write('\"');
-        break;
-    case '\\':
-        Nextion_Serial.write('\\');
-        Nextion_Serial.write('\\');
-        break;
-    case '\0':
-        break;
-    default:
-        Nextion_Serial.write(Value);
-        break;
-    }
-    Nextion_Serial.write('\"');
-    Instruction_End();
+    va_list Arguments;
+    va_start(Arguments, Format);
+    bool Complete = Set_Text_Format_Arguments(Object_Name, Format, Arguments);
+    va_end(Arguments);
+    return Complete;
 }
 
-void Nextion_Class::Delete_Text(const __FlashStringHelper *Component_Name, uint8_t Quantity)
+bool Nextion_Class::Set_Text_Format(const __FlashStringHelper *Object_Name, const char *Format, ...)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Component_Name);
-    Nextion_Serial.print(F(".txt-="));
-    Nextion_Serial.print(Quantity);
-    Instruction_End();
+    va_list Arguments;
+    va_start(Arguments, Format);
+    bool Complete = Set_Text_Format_Arguments(reinterpret_cast<const char *>(Object_Name), Format, Arguments);
+    va_end(Arguments);
+    return Complete;
+}
+
+bool Nextion_Class::Set_Text_Format_Arguments(const char *Object_Name, const char *Format, va_list Arguments)
+{
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".txt=\""));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    bool Complete = Instruction_Append_Format(Format, Arguments);
+    Instruction_Append('\"');
+    Instruction_End_Cached(Key_Size);
+    return Complete;
 }
 
-void Nextion_Class::Set_Value(const __FlashStringHelper *Object_Name, uint32_t Value)
+void Nextion_Class::Add_Text(const char *Object_Name, const char *Data, size_t Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".val="));
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".txt+=\""));
+    Instruction_Append_Escaped(Data, Size);
+    Instruction_Append('\"');
     Instruction_End();
 }
 
-void Nextion_Class::Set_Value(String const &Object_Name, uint32_t Value)
+void Nextion_Class::Delete_Text(const char *Object_Name, uint8_t Quantity)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".val="));
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".txt-="));
+    Instruction_Append_Number(Quantity);
     Instruction_End();
 }
 
 void Nextion_Class::Set_Value(const char *Object_Name, uint32_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".val="));
-    Nextion_Serial.print(Value);
-    Instruction_End();
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".val="));
+    uint16_t Key_Size = Frame_Size - Instruction_Offset;
+    Instruction_Append_Number(Value);
+    Instruction_End_Cached(Key_Size);
 }
 
-void Nextion_Class::Set_Maximum_Value(const __FlashStringHelper *Object_Name, uint16_t Value)
+void Nextion_Class::Set_Maximum_Value(const char *Object_Name, uint16_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".maxval="));
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".maxval="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Minimum_Value(const __FlashStringHelper *Object_Name, uint16_t Value)
+void Nextion_Class::Set_Minimum_Value(const char *Object_Name, uint16_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".minval="));
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".minval="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Global_Variable(const __FlashStringHelper *Object_Name, uint32_t Value)
+void Nextion_Class::Set_Global_Variable(const char *Object_Name, uint32_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print("=");
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append('=');
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Font(const __FlashStringHelper *Object_Name, uint8_t Font_ID)
+void Nextion_Class::Set_Font(const char *Object_Name, uint8_t Font_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".font="));
-    Nextion_Serial.print(Font_ID);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".font="));
+    Instruction_Append_Number(Font_ID);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Horizontal_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment)
+void Nextion_Class::Set_Horizontal_Alignment(const char *Object_Name, uint8_t Alignment)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".xcen="));
-    Nextion_Serial.print(Alignment);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".xcen="));
+    Instruction_Append_Number(Alignment);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Vertical_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment)
+void Nextion_Class::Set_Vertical_Alignment(const char *Object_Name, uint8_t Alignment)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".ycen="));
-    Nextion_Serial.print(Alignment);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".ycen="));
+    Instruction_Append_Number(Alignment);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Grid_Width(const __FlashStringHelper *Object_Name, uint16_t Width)
+void Nextion_Class::Set_Grid_Width(const char *Object_Name, uint16_t Width)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".gdw="));
-    Nextion_Serial.print(Width);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".gdw="));
+    Instruction_Append_Number(Width);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Grid_Height(const __FlashStringHelper *Object_Name, uint16_t Height)
+void Nextion_Class::Set_Grid_Height(const char *Object_Name, uint16_t Height)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".gdh="));
-    Nextion_Serial.print(Height);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".gdh="));
+    Instruction_Append_Number(Height);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Channel_Color(const __FlashStringHelper *Object_Name, uint8_t Channel_ID, uint16_t Color)
+void Nextion_Class::Set_Channel_Color(const char *Object_Name, uint8_t Channel_ID, uint16_t Color)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".pco"));
-    Nextion_Serial.print(Channel_ID);
-    Nextion_Serial.write('=');
-    Nextion_Serial.print(Color);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".pco"));
+    Instruction_Append_Number(Channel_ID);
+    Instruction_Append('=');
+    Instruction_Append_Number(Color);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Grid_Color(const __FlashStringHelper *Object_Name, uint16_t Color)
+void Nextion_Class::Set_Grid_Color(const char *Object_Name, uint16_t Color)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".gdc="));
-    Nextion_Serial.print(Color);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".gdc="));
+    Instruction_Append_Number(Color);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Data_Scaling(const __FlashStringHelper *Object_Name, uint16_t Scale)
+void Nextion_Class::Set_Data_Scaling(const char *Object_Name, uint16_t Scale)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
     if (Scale < 10 || Scale > 1000)
     {
         return;
     }
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".dis="));
-    Nextion_Serial.print(Scale);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".dis="));
+    Instruction_Append_Number(Scale);
     Instruction_End();
 }
 
 void Nextion_Class::Draw_Crop_Picture(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Picture_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("picq "));
-    Nextion_Serial.print(X_Coordinate);
+    Instruction_Start();
+    Instruction_Append(F("picq "));
+    Instruction_Append_Number(X_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
+    Instruction_Append_Number(Y_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Width);
+    Instruction_Append_Number(Width);
     Argument_Separator();
-    Nextion_Serial.print(Height);
+    Instruction_Append_Number(Height);
     Argument_Separator();
-    Nextion_Serial.print(Picture_ID);
+    Instruction_Append_Number(Picture_ID);
     Instruction_End();
 }
 
-void Nextion_Class::Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, String const &Text)
+void Nextion_Class::Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, const char *Text, size_t Size)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("xstr "));
-    Nextion_Serial.print(X_Coordinate);
+    Instruction_Start();
+    Instruction_Append(F("xstr "));
+    Instruction_Append_Number(X_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
+    Instruction_Append_Number(Y_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Width);
+    Instruction_Append_Number(Width);
     Argument_Separator();
-    Nextion_Serial.print(Height);
+    Instruction_Append_Number(Height);
     Argument_Separator();
-    Nextion_Serial.print(Font_ID);
+    Instruction_Append_Number(Font_ID);
     Argument_Separator();
-    Nextion_Serial.print(Text_Color);
+    Instruction_Append_Number(Text_Color);
     Argument_Separator();
-    Nextion_Serial.print(Background);
+    Instruction_Append_Number(Background);
     Argument_Separator();
-    Nextion_Serial.print(Horizontal_Alignment);
+    Instruction_Append_Number(Horizontal_Alignment);
     Argument_Separator();
-    Nextion_Serial.print(Vertical_Alignment);
+    Instruction_Append_Number(Vertical_Alignment);
     Argument_Separator();
-    Nextion_Serial.print(Background_Type);
+    Instruction_Append_Number(Background_Type);
     Argument_Separator();
-    Nextion_Serial.print('\"');
-    Nextion_Serial.print(Text);
-    Nextion_Serial.print('\"');
+    Instruction_Append('\"');
+    Instruction_Append_Escaped(Text, Size);
+    Instruction_Append('\"');
     Instruction_End();
 }
 
-void Nextion_Class::Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, const char *Text)
+void Nextion_Class::Draw_Picture(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("xstr "));
-    Nextion_Serial.print(X_Coordinate);
+    Instruction_Start();
+    Instruction_Append(F("pic "));
+    Instruction_Append_Number(X_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
+    Instruction_Append_Number(Y_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Width);
+    Instruction_Append_Number(Picture_ID);
+    Instruction_End();
+}
+
+void Nextion_Class::Draw_Circle(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Radius, uint16_t Color, bool Hollow)
+{
+    Instruction_Start();
+    if (Hollow)
+    {
+        Instruction_Append(F("cir "));
+    }
+    else
+    {
+        Instruction_Append(F("cirs "));
+    }
+    Instruction_Append_Number(X_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Height);
+    Instruction_Append_Number(Y_Coordinate);
     Argument_Separator();
-    Nextion_Serial.print(Font_ID);
+    Instruction_Append_Number(Radius);
     Argument_Separator();
-    Nextion_Serial.print(Text_Color);
+    Instruction_Append_Number(Color);
+    Instruction_End();
+}
+
+void Nextion_Class::Draw_Pixel(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Color)
+{
+    Draw_Rectangle(X_Coordinate, Y_Coordinate, 1, 1, Color);
+}
+
+void Nextion_Class::Draw_Rectangle(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Color, bool Hollow)
+{
+    Instruction_Start();
+    if (Hollow)
+    {
+        Instruction_Append(F("draw "));
+        Instruction_Append_Number(X_Coordinate);
+        Argument_Separator();
+        Instruction_Append_Number(Y_Coordinate);
+        Argument_Separator();
+        Instruction_Append_Number(X_Coordinate + Width);
+        Argument_Separator();
+        Instruction_Append_Number(Y_Coordinate + Height);
+    }
+    else
+    {
+        Instruction_Append(F("fill "));
+        Instruction_Append_Number(X_Coordinate);
+        Argument_Separator();
+        Instruction_Append_Number(Y_Coordinate);
+        Argument_Separator();
+        Instruction_Append_Number(Width);
+        Argument_Separator();
+        Instruction_Append_Number(Height);
+    }
+
     Argument_Separator();
-    Nextion_Serial.print(Background);
+    Instruction_Append_Number(Color);
+    Instruction_End();
+}
+
+void Nextion_Class::Draw_Line(uint16_t X_Start, uint16_t Y_Start, uint16_t X_End, uint16_t Y_End, uint16_t Color)
+{
+    Instruction_Start();
+    Instruction_Append(F("line "));
+    Instruction_Append_Number(X_Start);
     Argument_Separator();
-    Nextion_Serial.print(Horizontal_Alignment);
+    Instruction_Append_Number(Y_Start);
     Argument_Separator();
-    Nextion_Serial.print(Vertical_Alignment);
+    Instruction_Append_Number(X_End);
     Argument_Separator();
-    Nextion_Serial.print(Background_Type);
+    Instruction_Append_Number(Y_End);
     Argument_Separator();
-    Nextion_Serial.print('\"');
-    uint16_t i = 0;
-    while (1)
+    Instruction_Append_Number(Color);
+    Instruction_End();
+}
+
+void Nextion_Class::Calibrate()
+{
+    Instruction_Start();
+    Instruction_Append(F("touch_j"));
+    Instruction_End();
+}
+
+void Nextion_Class::Show(const char *Object_Name)
+{
+    Instruction_Start();
+    Instruction_Append(F("vis "));
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(",1"));
+    Instruction_End();
+}
+
+void Nextion_Class::Hide(const char *Object_Name)
+{
+    Instruction_Start();
+    Instruction_Append(F("vis "));
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(",0"));
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Touch_Event(const char *Object_Name, bool Enable)
+{
+    Instruction_Start();
+    Instruction_Append(F("tsw "));
+    Instruction_Append(Object_Name);
+    Argument_Separator();
+    Instruction_Append_Number(Enable);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Touch_Event(uint8_t Object_ID, bool Enable)
+{
+    Instruction_Start();
+    Instruction_Append(F("tsw "));
+    Instruction_Append_Number(Object_ID);
+    Argument_Separator();
+    Instruction_Append_Number(Enable);
+    Instruction_End();
+}
+
+void Nextion_Class::Set_Execution(bool Enable)
+{
+    Instruction_Start();
+    if (Enable == true)
     {
-        switch (Text[i])
-        {
-        case '\"':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\"');
-            break;
-        case '\\':
-            Nextion_Serial.write('\\');
-            Nextion_Serial.write('\\');
-            break;
-        case '\0':
-            Nextion_Serial.write('\"');
-            Instruction_End();
-            return;
-        default:
-            Nextion_Serial.write(Text[i]);
-            break;
-        }
-        i++;
+        Instruction_Append(F("com_star"));
     }
+    else
+    {
+        Instruction_Append(F("com_stop"));
+    }
+    Instruction_End();
 }
 
-void Nextion_Class::Draw_Picture(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID)
+void Nextion_Class::Click(const char *Object_Name, uint8_t Event_Type)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("pic "));
-    Nextion_Serial.print(X_Coordinate);
+    Instruction_Start();
+    Instruction_Append(F("click "));
+    Instruction_Append(Object_Name);
     Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
+    Instruction_Append_Number(Event_Type);
+    Instruction_End();
+}
+
+void Nextion_Class::Click(uint16_t Component_ID, uint8_t Event_Type)
+{
+    Instruction_Start();
+    Instruction_Append(F("click "));
+    Instruction_Append_Number(Component_ID);
     Argument_Separator();
-    Nextion_Serial.print(Picture_ID);
+    Instruction_Append_Number(Event_Type);
     Instruction_End();
 }
 
-void Nextion_Class::Draw_Circle(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Radius, uint16_t Color, bool Hollow)
+void Nextion_Class::Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, uint8_t *Data, uint32_t Quantity)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Hollow)
+    Instruction_Start();
+    if (Quantity == 0)
     {
-        Nextion_Serial.print(F("cir "));
+        Instruction_Append(F("add "));
+        Instruction_Append_Number(Component_ID);
+        Argument_Separator();
+        Instruction_Append_Number(Channel);
+        Argument_Separator();
+        Instruction_Append_Number(Data[0]);
+        Instruction_End();
     }
     else
     {
-        Nextion_Serial.print(F("cirs "));
+        Transparent_Transfer(Component_ID, Channel, Data, Quantity);
+        Give_Serial_Semaphore();
+    }
+}
+
+///
+/// @brief Add samples to a waveform, reduced to its pixel budget with a minimum / maximum decimation and scaled to the 0 - 255 range.
+///
+/// @param Component_ID Waveform component ID.
+/// @param Channel Waveform channel.
+/// @param Data Samples.
+/// @param Quantity Number of samples.
+/// @param Width Pixel budget (usually the waveform width), from 2 to Nextion_Maximum_Waveform_Width.
+/// @param Minimum Value mapped to the bottom of the waveform.
+/// @param Maximum Value mapped to the top of the waveform.
+void Nextion_Class::Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint32_t Quantity, uint16_t Width, uint8_t Minimum, uint8_t Maximum)
+{
+    Add_Decimated_Value_Waveform(Component_ID, Channel, Data, Quantity, Width, Minimum, Maximum);
+}
+
+void Nextion_Class::Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const int16_t *Data, uint32_t Quantity, uint16_t Width, int16_t Minimum, int16_t Maximum)
+{
+    Add_Decimated_Value_Waveform(Component_ID, Channel, Data, Quantity, Width, Minimum, Maximum);
+}
+
+void Nextion_Class::Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const float *Data, uint32_t Quantity, uint16_t Width, float Minimum, float Maximum)
+{
+    Add_Decimated_Value_Waveform(Component_ID, Channel, Data, Quantity, Width, Minimum, Maximum);
+}
+
+template <typename Type>
+void Nextion_Class::Add_Decimated_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const Type *Data, uint32_t Quantity, uint16_t Width, Type Minimum, Type Maximum)
+{
+    // -- A bucket produces its minimum and its maximum : a single pixel cannot hold both.
+    if (Quantity == 0 || Width < 2)
+    {
+        return;
+    }
+    if (Width > Nextion_Maximum_Waveform_Width)
+    {
+        Width = Nextion_Maximum_Waveform_Width;
+    }
+
+    uint8_t Samples[Nextion_Maximum_Waveform_Width];
+    uint32_t Size = Nextion_Decimate(Data, Quantity, Samples, Width, Minimum, Maximum);
+    if (Size != 0)
+    {
+        Add_Value_Waveform(Component_ID, Channel, Samples, Size);
+    }
+}
+
+///
+/// @brief Send samples to a waveform channel with transparent data transfers (addt). The serial semaphore must be held.
+/// @details Each transfer is paced by the display : the data is written as soon as it is ready (0xFE), and the transfer is over once it has finished (0xFD). Arrays larger than the display serial buffer are split in several transfers.
+///
+/// @return true if every transfer has been confirmed by the display, false otherwise.
+bool Nextion_Class::Transparent_Transfer(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint32_t Quantity)
+{
+    bool Confirmed = true;
+
+    while (Quantity > 0)
+    {
+        uint32_t Size = (Quantity > Nextion_Transparent_Chunk_Size) ? Nextion_Transparent_Chunk_Size : Quantity;
+
+        uint8_t Waiter = Register_Waiter(Transparent_Data_Ready);
+        Instruction_Append(F("addt "));
+        Instruction_Append_Number(Component_ID);
+        Argument_Separator();
+        Instruction_Append_Number(Channel);
+        Argument_Separator();
+        Instruction_Append_Number(Size);
+        Instruction_Send(Frame_Transparent);
+        Flush(); // -- The header must be on the wire before the data.
+
+        if (Waiter == Nextion_Maximum_Waiters)
+        {
+            vTaskDelay(pdMS_TO_TICKS(10)); // -- No waiter left : give the display the time to prepare transparent mode.
+        }
+        else if (!Wait_For_Event(Waiter, Nextion_Transparent_Time_Out))
+        {
+            // -- Not in transparent mode : the data would be interpreted as instructions.
+            Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN"));
+            Instruction_Send(Frame_Reset);
+            return false;
+        }
+
+        Waiter = Register_Waiter(Transparent_Data_Finished);
+        Write_Transport(Data, Size);
+
+        // -- Time to receive the data, plus the display processing time.
+        if (!Wait_For_Event(Waiter, (Size * 10000 / Baud_Rate) + Nextion_Transparent_Time_Out))
+        {
+            Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN")); // ensure that display is not in transparent mode anymore
+            Instruction_Send(Frame_Reset);
+            Confirmed = false;
+        }
+
+        Data += Size;
+        Quantity -= Size;
+    }
+
+    return Confirmed;
+}
+
+///
+/// @brief Register a waveform stream : samples pushed to it are buffered and sent in a single transparent transfer (addt) when enough of them are pending, or when the oldest one is too old.
+/// @details The age is checked on each push and by Loop(). The last Capacity samples are kept : when the page owning the waveform is displayed again, they are sent back in a single transfer, and samples pushed while it is hidden are only stored.
+///
+/// @param Component_ID Waveform component ID.
+/// @param Channel Waveform channel.
+/// @param Capacity Size of the sample history (usually the waveform width).
+/// @param Flush_Size Number of pending samples that triggers a transfer.
+/// @param Flush_Age Age of the oldest pending sample that triggers a transfer (in milliseconds).
+/// @param Page_ID Page owning the waveform, 0xFF to consider it always displayed.
+/// @return true if the stream has been registered, false otherwise.
+bool Nextion_Class::Add_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, uint16_t Capacity, uint16_t Flush_Size, uint32_t Flush_Age, uint8_t Page_ID)
+{
+    if (Capacity == 0)
+    {
+        return false;
+    }
+    if (Flush_Size == 0 || Flush_Size > Capacity)
+    {
+        Flush_Size = Capacity;
+    }
+
+    Remove_Waveform_Stream(Component_ID, Channel);
+
+    uint8_t *Samples = new (std::nothrow) uint8_t[Capacity];
+    if (Samples == NULL)
+    {
+        return false;
+    }
+
+    Take_Serial_Semaphore();
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+    {
+        Waveform_Stream_Type &Stream = Waveform_Streams[i];
+        if (Stream.Samples == NULL)
+        {
+            Stream.Capacity = Capacity;
+            Stream.Head = 0;
+            Stream.Count = 0;
+            Stream.Pending = 0;
+            Stream.Flush_Size = Flush_Size;
+            Stream.Flush_Age = Flush_Age;
+            Stream.Component_ID = Component_ID;
+            Stream.Channel = Channel;
+            Stream.Page_ID = Page_ID;
+            Stream.Backfill = false;
+            Stream.Samples = Samples;
+            Give_Serial_Semaphore();
+            return true;
+        }
+    }
+    Give_Serial_Semaphore();
+
+    delete[] Samples;
+    return false;
+}
+
+///
+/// @brief Unregister a waveform stream. Pending samples are dropped.
+///
+void Nextion_Class::Remove_Waveform_Stream(uint8_t Component_ID, uint8_t Channel)
+{
+    Take_Serial_Semaphore();
+    Waveform_Stream_Type *Stream = Find_Waveform_Stream(Component_ID, Channel);
+    if (Stream != NULL)
+    {
+        delete[] Stream->Samples;
+        Stream->Samples = NULL;
+    }
+    Give_Serial_Semaphore();
+}
+
+///
+/// @brief Push a sample to a waveform stream.
+///
+/// @return true if the sample has been pushed, false if the stream is not registered.
+bool Nextion_Class::Push_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, uint8_t Value)
+{
+    return Push_Waveform_Stream(Component_ID, Channel, &Value, 1);
+}
+
+///
+/// @brief Push samples to a waveform stream.
+///
+/// @return true if the samples have been pushed, false if the stream is not registered.
+bool Nextion_Class::Push_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint16_t Quantity)
+{
+    Instruction_Start();
+    Waveform_Stream_Type *Stream = Find_Waveform_Stream(Component_ID, Channel);
+    if (Stream == NULL)
+    {
+        Give_Serial_Semaphore();
+        return false;
+    }
+
+    bool Visible = Is_Waveform_Stream_Visible(*Stream);
+    if (Visible && Stream->Backfill)
+    {
+        Backfill_Waveform_Stream(*Stream);
+    }
+
+    while (Quantity > 0)
+    {
+        if (Visible && Stream->Pending == 0)
+        {
+            Stream->Oldest_Pending_Time = millis();
+        }
+
+        // -- Copy up to the end of the ring and, when displayed, up to the flush threshold.
+        uint16_t Size = Stream->Capacity - Stream->Head;
+        if (Visible && Size > Stream->Flush_Size - Stream->Pending)
+        {
+            Size = Stream->Flush_Size - Stream->Pending;
+        }
+        if (Size > Quantity)
+        {
+            Size = Quantity;
+        }
+        memcpy(Stream->Samples + Stream->Head, Data, Size);
+        Stream->Head = (Stream->Head + Size) % Stream->Capacity;
+        Stream->Count = (Stream->Count + Size > Stream->Capacity) ? Stream->Capacity : Stream->Count + Size;
+        Data += Size;
+        Quantity -= Size;
+
+        if (!Visible) // -- Only kept in history.
+        {
+            continue;
+        }
+
+        Stream->Pending += Size;
+        if (Stream->Pending >= Stream->Flush_Size || (millis() - Stream->Oldest_Pending_Time) >= Stream->Flush_Age)
+        {
+            // -- Send the other channels of the waveform in the same burst, so that they stay in step.
+            for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+            {
+                if (Waveform_Streams[i].Samples != NULL && Waveform_Streams[i].Component_ID == Component_ID)
+                {
+                    Flush_Waveform_Stream(Waveform_Streams[i]);
+                }
+            }
+        }
+    }
+
+    Give_Serial_Semaphore();
+    return true;
+}
+
+///
+/// @brief Send the pending samples of every waveform stream.
+///
+void Nextion_Class::Flush_Waveform_Streams()
+{
+    Instruction_Start();
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+    {
+        if (Waveform_Streams[i].Samples != NULL)
+        {
+            Flush_Waveform_Stream(Waveform_Streams[i]);
+        }
+    }
+    Give_Serial_Semaphore();
+}
+
+Nextion_Class::Waveform_Stream_Type *Nextion_Class::Find_Waveform_Stream(uint8_t Component_ID, uint8_t Channel)
+{
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+    {
+        if (Waveform_Streams[i].Samples != NULL && Waveform_Streams[i].Component_ID == Component_ID && Waveform_Streams[i].Channel == Channel)
+        {
+            return &Waveform_Streams[i];
+        }
+    }
+    return NULL;
+}
+
+///
+/// @brief Check if the page owning a waveform stream is displayed.
+///
+bool Nextion_Class::Is_Waveform_Stream_Visible(Waveform_Stream_Type const &Stream)
+{
+    return Stream.Page_ID == 0xFF || Stream.Page_ID == Page_History[0];
+}
+
+///
+/// @brief Send the last samples of a stream. The serial semaphore must be held.
+///
+void Nextion_Class::Send_Waveform_Stream(Waveform_Stream_Type &Stream, uint16_t Size)
+{
+    uint16_t Tail = (Stream.Head + Stream.Capacity - Size) % Stream.Capacity;
+
+    // -- The samples wrap around the end of the ring : rotate it in place so that they are contiguous, and sent in a single transfer.
+    if (Tail + Size > Stream.Capacity)
+    {
+        Reverse_Samples(Stream.Samples, Tail);
+        Reverse_Samples(Stream.Samples + Tail, Stream.Capacity - Tail);
+        Reverse_Samples(Stream.Samples, Stream.Capacity);
+        Stream.Head = (Stream.Head + Stream.Capacity - Tail) % Stream.Capacity;
+        Tail = 0;
+    }
+
+    Transparent_Transfer(Stream.Component_ID, Stream.Channel, Stream.Samples + Tail, Size);
+}
+
+///
+/// @brief Send the pending samples of a stream. The serial semaphore must be held.
+/// @details Pending samples of a hidden waveform are dropped : they remain in history and are sent by the backfill.
+///
+void Nextion_Class::Flush_Waveform_Stream(Waveform_Stream_Type &Stream)
+{
+    if (Stream.Pending != 0 && Is_Waveform_Stream_Visible(Stream))
+    {
+        Send_Waveform_Stream(Stream, Stream.Pending);
     }
-    Nextion_Serial.print(X_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Y_Coordinate);
-    Argument_Separator();
-    Nextion_Serial.print(Radius);
-    Argument_Separator();
-    Nextion_Serial.print(Color);
-    Instruction_End();
+    Stream.Pending = 0;
 }
 
-void Nextion_Class::Draw_Pixel(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Color)
+///
+/// @brief Send the whole history of a stream, after its page has been displayed again. The serial semaphore must be held.
+///
+void Nextion_Class::Backfill_Waveform_Stream(Waveform_Stream_Type &Stream)
 {
-    Draw_Rectangle(X_Coordinate, Y_Coordinate, 1, 1, Color);
+    Stream.Backfill = false;
+    if (Stream.Count != 0)
+    {
+        Send_Waveform_Stream(Stream, Stream.Count);
+    }
+    Stream.Pending = 0;
 }
 
-void Nextion_Class::Draw_Rectangle(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Color, bool Hollow)
+///
+/// @brief Backfill the streams whose page has been displayed again, and send the pending samples of the streams whose oldest sample is too old.
+///
+void Nextion_Class::Check_Waveform_Streams()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Hollow)
+    uint32_t Now = millis();
+    bool Expired = false;
+
+    // -- Unlocked pre-check : most calls have nothing to send.
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
     {
-        Nextion_Serial.print(F("draw "));
-        Nextion_Serial.print(X_Coordinate);
-        Argument_Separator();
-        Nextion_Serial.print(Y_Coordinate);
-        Argument_Separator();
-        Nextion_Serial.print(X_Coordinate + Width);
-        Argument_Separator();
-        Nextion_Serial.print(Y_Coordinate + Height);
+        const Waveform_Stream_Type &Stream = Waveform_Streams[i];
+        if (Stream.Samples != NULL && ((Stream.Backfill && Is_Waveform_Stream_Visible(Stream)) || (Stream.Pending != 0 && (Now - Stream.Oldest_Pending_Time) >= Stream.Flush_Age)))
+        {
+            Expired = true;
+            break;
+        }
     }
-    else
+    if (!Expired)
     {
-        Nextion_Serial.print(F("fill "));
-        Nextion_Serial.print(X_Coordinate);
-        Argument_Separator();
-        Nextion_Serial.print(Y_Coordinate);
-        Argument_Separator();
-        Nextion_Serial.print(Width);
-        Argument_Separator();
-        Nextion_Serial.print(Height);
+        return;
     }
 
-    Argument_Separator();
-    Nextion_Serial.print(Color);
-    Instruction_End();
+    Instruction_Start();
+    Now = millis();
+    for (uint8_t i = 0; i < Nextion_Maximum_Waveform_Streams; i++)
+    {
+        Waveform_Stream_Type &Stream = Waveform_Streams[i];
+        if (Stream.Samples == NULL)
+        {
+            continue;
+        }
+        if (Stream.Backfill && Is_Waveform_Stream_Visible(Stream))
+        {
+            Backfill_Waveform_Stream(Stream);
+        }
+        else if (Stream.Pending != 0 && (Now - Stream.Oldest_Pending_Time) >= Stream.Flush_Age)
+        {
+            Flush_Waveform_Stream(Stream);
+        }
+    }
+    Give_Serial_Semaphore();
 }
 
-void Nextion_Class::Draw_Line(uint16_t X_Start, uint16_t Y_Start, uint16_t X_End, uint16_t Y_End, uint16_t Color)
+void Nextion_Class::Clear_Waveform(uint16_t Component_ID, uint8_t Channel)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("line "));
-    Nextion_Serial.print(X_Start);
+    Instruction_Start();
+    Instruction_Append(F("cle "));
+    Instruction_Append_Number(Component_ID);
     Argument_Separator();
-    Nextion_Serial.print(Y_Start);
-    Argument_Separator();
-    Nextion_Serial.print(X_End);
-    Argument_Separator();
-    Nextion_Serial.print(Y_End);
-    Argument_Separator();
-    Nextion_Serial.print(Color);
+    Instruction_Append_Number(Channel);
     Instruction_End();
 }
 
-void Nextion_Class::Calibrate()
+void Nextion_Class::Reboot()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("touch_j"));
+    Invalidate_Shadow_Cache();
+    Instruction_Start();
+    Instruction_Append(F("rest"));
     Instruction_End();
 }
 
-void Nextion_Class::Show(const __FlashStringHelper *Object_Name)
+void Nextion_Class::Set_Standby_Serial_Timer(uint16_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("1");
+    Instruction_Start();
+    Instruction_Append(F("ussp="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Show(String const &Object_Name)
-{
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("1");
-    Instruction_End();
-}
-void Nextion_Class::Show(const char *Object_Name)
+void Nextion_Class::Set_Standby_Touch_Timer(uint16_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("1");
+    Instruction_Start();
+    Instruction_Append(F("thsp="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Hide(const __FlashStringHelper *Object_Name)
+void Nextion_Class::Set_Touch_Wake_Up(bool Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("0");
+    Instruction_Start();
+    Instruction_Append(F("thup="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Hide(String const &Object_Name)
+void Nextion_Class::Set_Serial_Wake_Up(bool Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("0");
+    Instruction_Start();
+    Instruction_Append(F("usup="));
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
-void Nextion_Class::Hide(const char *Object_Name)
+
+void Nextion_Class::Start_Sending_Realtime_Coordinate()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("vis "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print("0");
+    Instruction_Start();
+    Instruction_Append(F("sendxy=1"));
     Instruction_End();
 }
 
-void Nextion_Class::Set_Touch_Event(const __FlashStringHelper *Object_Name, bool Enable)
+void Nextion_Class::Stop_Sending_Realtime_Coordinate()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("tsw "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print(Enable);
+    Instruction_Start();
+    Instruction_Append(F("sendxy=0"));
     Instruction_End();
 }
 
-void Nextion_Class::Set_Execution(bool Enable)
+///
+/// @brief Set the level of replies sent by the display (bkcmd).
+/// @details In acknowledged mode, the level is only recorded and sent when the mode is disabled, as the mode needs every instruction to be acknowledged.
+///
+/// @param Level 0 : no reply, 1 : success only, 2 : errors only (default), 3 : always.
+void Nextion_Class::Set_Debugging(uint8_t Level)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    if (Enable == true)
-    {
-        Nextion_Serial.print(F("com_star"));
-    }
-    else
+    Instruction_Start();
+    Debugging_Level = Level;
+    if (Window_Semaphore != NULL)
     {
-        Nextion_Serial.print(F("com_stop"));
+        Frame_Size = Instruction_Offset;
+        Give_Serial_Semaphore();
+        return;
     }
+    Instruction_Append(F("bkcmd="));
+    Instruction_Append_Number(Level);
     Instruction_End();
 }
 
-void Nextion_Class::Click(const __FlashStringHelper *Object_Name, uint8_t Event_Type)
+void Nextion_Class::Set_Wordwrap(const char *Object_Name, bool Wordwrap)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("click "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print(Event_Type);
+    Instruction_Start();
+    Instruction_Append(Object_Name);
+    Instruction_Append(F(".isbr="));
+    Instruction_Append_Number(Wordwrap);
     Instruction_End();
 }
 
-void Nextion_Class::Click(const char *Object_Name, uint8_t Event_Type)
+void Nextion_Class::Set_Wake_Up_Page(uint8_t Page_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("click "));
-    Nextion_Serial.print(Object_Name);
-    Argument_Separator();
-    Nextion_Serial.print(Event_Type);
+    Instruction_Start();
+    Instruction_Append(F("wup="));
+    Instruction_Append_Number(Page_ID);
     Instruction_End();
 }
 
-void Nextion_Class::Click(uint16_t Component_ID, uint8_t Event_Type)
+void Nextion_Class::Delay(uint16_t Delay_Time)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("click "));
-    Nextion_Serial.print(Component_ID);
-    Argument_Separator();
-    Nextion_Serial.print(Event_Type);
+    Instruction_Start();
+    Instruction_Append(F("delay="));
+    Instruction_Append_Number(Delay_Time);
     Instruction_End();
 }
 
-void Nextion_Class::Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, uint8_t *Data, uint32_t Quantity)
+///
+/// @brief Upload a TFT file to the display.
+/// @details The file is sent in 4096 bytes chunks, the next chunk being read while the display receives and stores the current one. The read overlaps the whole transmission only if the transport buffers a chunk (Nextion_UART_Transmit_Buffer_Size for the UART transport).
+///
+/// @param Update_File TFT file.
+/// @return Update_Succeed or Update_Failed.
+uint8_t Nextion_Class::Update(File Update_File)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("add"));
-    if (Quantity == 0)
+    if (!Update_File || Update_File.isDirectory())
     {
-        Nextion_Serial.write(' ');
-        Nextion_Serial.print(Component_ID);
-        Argument_Separator();
-        Nextion_Serial.print(Channel);
-        Argument_Separator();
-        Nextion_Serial.print(Data[0]);
-        Instruction_End();
+        return Update_Failed;
     }
-    else
+
+    uint8_t *Buffers = new (std::nothrow) uint8_t[2 * Update_Chunk_Size];
+    if (Buffers == NULL)
     {
-        Nextion_Serial.print("t ");
-        Nextion_Serial.print(Component_ID);
-        Argument_Separator();
-        Nextion_Serial.print(Channel);
-        Argument_Separator();
-        Nextion_Serial.print(Quantity);
-        Nextion_Serial.print(F("\xFF\xFF\xFF"));
-        vTaskDelay(pdMS_TO_TICKS(10)); //wait display to prepare transparent mode
-        Nextion_Serial.write(Data, Quantity);
-        Nextion_Serial.print(F("DRAKJHSUYDGBNCJHGJKSHBDN")); // ensure that display is not in transparent mode anymore
-        Instruction_End();
+        return Update_Failed;
+    }
+
+    // -- The upload writes directly to the UART : asynchronous transmission is suspended.
+    bool Asynchronous = (Transmit_Ring_Buffer != NULL);
+    Set_Asynchronous_Transmission(false);
+
+    // -- The upload reads directly from the UART : prevent the parser from consuming replies.
+    Instruction_Start();
+    xSemaphoreTake(Receive_Semaphore, portMAX_DELAY);
+    Receive_Position = Receive_Size = 0;
+
+    memset(&Update_Statistics, 0, sizeof(Update_Statistics));
+    uint8_t Result = Upload(Update_File, Buffers);
+
+    Give_Serial_Semaphore();
+    xSemaphoreGive(Receive_Semaphore);
+
+    if (Asynchronous)
+    {
+        Set_Asynchronous_Transmission(true, Transmit_Queue_Size, Transmit_Policy, Transmit_Priority, Transmit_Stack_Size);
     }
+
+    delete[] Buffers;
+    return Result;
 }
 
-void Nextion_Class::Clear_Waveform(uint16_t Component_ID, uint8_t Channel)
+///
+/// @brief Return the timing of the last update.
+///
+Nextion_Class::Update_Statistics_Type Nextion_Class::Get_Update_Statistics()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("cle "));
-    Nextion_Serial.print(Component_ID);
-    Argument_Separator();
-    Nextion_Serial.print(Channel);
-    Instruction_End();
+    return Update_Statistics;
 }
 
-void Nextion_Class::Reboot()
+void Nextion_Class::Set_Value(Nextion_Number_Class const &Number, uint32_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("rest"));
-    Instruction_End();
+    Instruction_Start();
+    Instruction_Append(Number.Value);
+    Instruction_Append_Number(Value);
+    Instruction_End_Cached(Number.Value.Size);
 }
 
-void Nextion_Class::Set_Standby_Serial_Timer(uint16_t Value)
+void Nextion_Class::Set_Value(Nextion_Progress_Bar_Class const &Progress_Bar, uint8_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("ussp="));
-    Nextion_Serial.print(Value);
-    Instruction_End();
+    Instruction_Start();
+    Instruction_Append(Progress_Bar.Value);
+    Instruction_Append_Number(Value);
+    Instruction_End_Cached(Progress_Bar.Value.Size);
 }
 
-void Nextion_Class::Set_Standby_Touch_Timer(uint16_t Value)
+void Nextion_Class::Set_Text(Nextion_Text_Class const &Text, const char *Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("thsp="));
-    Nextion_Serial.print(Value);
-    Instruction_End();
+    Instruction_Start();
+    Instruction_Append(Text.Text);
+    Instruction_Append_Escaped(Value);
+    Instruction_Append('\"');
+    Instruction_End_Cached(Text.Text.Size);
 }
 
-void Nextion_Class::Set_Touch_Wake_Up(bool Value)
+void Nextion_Class::Add_Text(Nextion_Text_Class const &Text, const char *Data)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("thup="));
-    Nextion_Serial.print(Value);
+    Instruction_Start();
+    Instruction_Append(Text.Added_Text);
+    Instruction_Append_Escaped(Data);
+    Instruction_Append('\"');
     Instruction_End();
 }
 
-void Nextion_Class::Set_Serial_Wake_Up(bool Value)
+void Nextion_Class::Set_Picture(Nextion_Picture_Class const &Picture, uint8_t Picture_ID)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("usup="));
-    Nextion_Serial.print(Value);
-    Instruction_End();
+    Instruction_Start();
+    Instruction_Append(Picture.Picture);
+    Instruction_Append_Number(Picture_ID);
+    Instruction_End_Cached(Picture.Picture.Size);
 }
 
-void Nextion_Class::Set_Debugging(uint8_t Level)
+void Nextion_Class::Add_Value_Waveform(Nextion_Waveform_Class const &Waveform, uint8_t Value)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("bkcmd="));
-    Nextion_Serial.print(Level);
+    Instruction_Start();
+    Instruction_Append(Waveform.Add);
+    Instruction_Append_Number(Value);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Wordwrap(const __FlashStringHelper *Object_Name, bool Wordwrap)
+void Nextion_Class::Add_Value_Waveform(Nextion_Waveform_Class const &Waveform, uint8_t *Data, uint32_t Quantity)
+{
+    Add_Value_Waveform(Waveform.Component_ID, Waveform.Channel, Data, Quantity);
+}
+
+void Nextion_Class::Clear_Waveform(Nextion_Waveform_Class const &Waveform)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(Object_Name);
-    Nextion_Serial.print(F(".isbr="));
-    Nextion_Serial.print(Wordwrap);
+    Instruction_Start();
+    Instruction_Append(Waveform.Clear);
     Instruction_End();
 }
 
-void Nextion_Class::Set_Wake_Up_Page(uint8_t Page_ID)
+void Nextion_Class::Show(Nextion_Component_Class const &Component)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("wup="));
-    Nextion_Serial.print(Page_ID);
+    Instruction_Start();
+    Instruction_Append(Component.Visibility);
+    Instruction_Append('1');
     Instruction_End();
 }
 
-void Nextion_Class::Delay(uint16_t Delay_Time)
+void Nextion_Class::Hide(Nextion_Component_Class const &Component)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("delay="));
-    Nextion_Serial.print(Delay_Time);
+    Instruction_Start();
+    Instruction_Append(Component.Visibility);
+    Instruction_Append('0');
     Instruction_End();
 }
 
-uint8_t Nextion_Class::Update(File Update_File)
+///
+/// @brief Return a snapshot of the link statistics since the last reset.
+/// @details The counters are read without locking : a snapshot taken while the link is busy may be slightly inconsistent. Everything is 0 when Nextion_Statistics is disabled.
+///
+Nextion_Class::Statistics_Type Nextion_Class::Get_Statistics()
 {
-    if (!Update_File || Update_File.isDirectory())
+    Statistics_Type Snapshot;
+#if Nextion_Statistics
+    Snapshot = Statistics;
+    Snapshot.Receive_Overflows = (Transport != NULL) ? Transport->Get_Overflows() - Receive_Overflows_Origin : 0;
+#else
+    memset(&Snapshot, 0, sizeof(Snapshot));
+#endif
+    return Snapshot;
+}
+
+///
+/// @brief Dump the protocol trace as a binary blob, to be decoded by extras/Trace.
+/// @details Blob format (little endian) : "NXTR", version (1 byte), recorded bytes per frame (1 byte), number of records (2 bytes), then the records from the oldest to the newest : time in microseconds (4 bytes), frame size (2 bytes), direction (1 byte, 0 transmitted, 1 received), and the first min(frame size, recorded bytes per frame) bytes of the frame. Received frames are recorded as their return code followed by their payload, without terminator.
+/// The oldest records are left out if the buffer is too small. Records written during the dump may be inconsistent.
+///
+/// @param Buffer Buffer receiving the blob.
+/// @param Size Size of the buffer (8 + Nextion_Trace_Size * (7 + Nextion_Trace_Frame_Size) bytes at most are needed).
+/// @return Size of the blob, 0 if the buffer is too small or the trace disabled.
+size_t Nextion_Class::Dump_Trace(uint8_t *Buffer, size_t Size)
+{
+#if Nextion_Trace_Size > 0
+    if (Size < 8)
     {
-        return Update_Failed;
+        return 0;
     }
 
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
+    uint32_t Head = __atomic_load_n(&Trace_Head, __ATOMIC_RELAXED);
+    uint32_t Count = (Head < Nextion_Trace_Size) ? Head : Nextion_Trace_Size;
 
-    vTaskDelay(pdMS_TO_TICKS(250));
-
-    while (Nextion_Serial.available()) //clear serial buffer
+    // -- Keep the newest records fitting in the buffer.
+    size_t Blob_Size = 8;
+    uint32_t Kept = 0;
+    while (Kept < Count)
     {
+        Trace_Record_Type &Record = Trace_Records[(Head - Kept - 1) % Nextion_Trace_Size];
+        size_t Record_Size = 7 + ((Record.Size < Nextion_Trace_Frame_Size) ? Record.Size : Nextion_Trace_Frame_Size);
+        if (Blob_Size + Record_Size > Size)
+        {
+            break;
+        }
+        Blob_Size += Record_Size;
+        Kept++;
+    }
 
-        Nextion_Serial.read();
+    uint8_t *Output = Buffer + 8;
+    uint16_t Written = 0;
+    for (uint32_t i = Head - Kept; i != Head; i++)
+    {
+        Trace_Record_Type &Record = Trace_Records[i % Nextion_Trace_Size];
+        uint16_t Recorded_Size = (Record.Size < Nextion_Trace_Frame_Size) ? Record.Size : Nextion_Trace_Frame_Size;
+        if ((size_t)(Output - Buffer) + 7 + Recorded_Size > Size) // -- Overwritten since it was measured.
+        {
+            break;
+        }
+        Output[0] = Record.Time;
+        Output[1] = Record.Time >> 8;
+        Output[2] = Record.Time >> 16;
+        Output[3] = Record.Time >> 24;
+        Output[4] = Record.Size;
+        Output[5] = Record.Size >> 8;
+        Output[6] = Record.Direction;
+        memcpy(Output + 7, Record.Data, Recorded_Size);
+        Output += 7 + Recorded_Size;
+        Written++;
     }
 
-    uint32_t Timeout;
+    memcpy(Buffer, "NXTR", 4);
+    Buffer[4] = 1; // -- Version.
+    Buffer[5] = Nextion_Trace_Frame_Size;
+    Buffer[6] = Written;
+    Buffer[7] = Written >> 8;
+    return Output - Buffer;
+#else
+    return 0;
+#endif
+}
+
+///
+/// @brief Clear the protocol trace.
+///
+void Nextion_Class::Clear_Trace()
+{
+#if Nextion_Trace_Size > 0
+    __atomic_store_n(&Trace_Head, 0, __ATOMIC_RELAXED);
+#endif
+}
 
-    uint8_t i;
+///
+/// @brief Reset the link statistics.
+///
+void Nextion_Class::Reset_Statistics()
+{
+#if Nextion_Statistics
+    memset(&Statistics, 0, sizeof(Statistics));
+    Receive_Overflows_Origin = (Transport != NULL) ? Transport->Get_Overflows() : 0;
+#endif
+}
 
-    const uint32_t Baud_Rate[] = {2400, 4800, 9600, 19200, 31250, 38400, 57600, 115200, 230400, 250000, 256000, 921600};
+///
+/// @brief Find the display baud rate and connect to it.
+/// @details The last baud rate the display answered at is tried first, then the one given to Begin(), then the most common ones.
+///
+/// @param Baud_Rate Baud rate found.
+/// @return true if the display answered, false otherwise.
+bool Nextion_Class::Connect(uint32_t &Baud_Rate)
+{
+    // -- Most common first : factory default, then the usual rates.
+    const uint32_t Common_Baud_Rates[] = {9600, 115200, 921600, 57600, 38400, 19200, 230400, 250000, 256000, 512000, 31250, 4800, 2400};
+    uint32_t Baud_Rates[2 + sizeof(Common_Baud_Rates) / sizeof(Common_Baud_Rates[0])];
+    uint8_t Count = 0;
+
+#if Nextion_Baud_Rate_Persistence
+    Preferences Storage;
+    if (Storage.begin("Nextion", true))
+    {
+        Baud_Rates[Count++] = Storage.getUInt("Baud_Rate", this->Baud_Rate);
+        Storage.end();
+    }
+#endif
+    Baud_Rates[Count++] = this->Baud_Rate;
+    for (uint8_t i = 0; i < sizeof(Common_Baud_Rates) / sizeof(Common_Baud_Rates[0]); i++)
+    {
+        Baud_Rates[Count++] = Common_Baud_Rates[i];
+    }
 
-    for (i = 0; i <= 12; i++)
+    bool Found = false;
+    for (uint8_t i = 0; i < Count && !Found; i++)
     {
-        if (i == 12)
+        bool Already_Tried = false;
+        for (uint8_t j = 0; j < i; j++)
         {
-            return Update_Failed;
+            if (Baud_Rates[j] == Baud_Rates[i])
+            {
+                Already_Tried = true;
+                break;
+            }
         }
-        Nextion_Serial.updateBaudRate(Baud_Rate[i]);
-
-        Nextion_Serial.print(F("DRAKJHSUYDGBNCJHGJKSHBDN\xFF\xFF\xFF"));
-        Nextion_Serial.print(F("connect\xFF\xFF\xFF"));
-
-        Timeout = millis() + ((1000000 / Baud_Rate[i]) + 30);
-        while (millis() <= Timeout)
+        if (!Already_Tried && Probe(Baud_Rates[i]))
         {
+            Baud_Rate = Baud_Rates[i];
+            Found = true;
         }
+    }
+
+    if (Found)
+    {
+        Save_Baud_Rate(Baud_Rate);
+    }
+    return Found;
+}
+
+///
+/// @brief Check if the display answers at a given baud rate.
+///
+/// @param Baud_Rate Baud rate to try.
+/// @return true if the display answered, false otherwise.
+bool Nextion_Class::Probe(uint32_t Baud_Rate)
+{
+    Transport->Set_Baud_Rate(Baud_Rate);
+    Transport->Clear();
+
+    Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN"));
+    Instruction_Send();
+    Instruction_Append(F("connect"));
+    Instruction_Send();
 
-        char Temporary_String[5];
-        Nextion_Serial.readBytes(Temporary_String, 5);
-        if (memcmp(Temporary_String, "comok", sizeof(Temporary_String)) == 0)
+    // -- Time to receive the answer (about 64 bytes), plus the display processing time.
+    uint32_t Time_Out = (640000 / Baud_Rate) + 30;
+    uint32_t Start_Time = millis();
+    uint8_t Matched = 0;
+    uint8_t Terminator_Count = 0;
+
+    while ((millis() - Start_Time) <= Time_Out)
+    {
+        int Byte;
+        while ((Byte = Transport->Read_Byte()) >= 0)
         {
-            while (Nextion_Serial.available())
+            if (Matched < 5)
+            {
+                if (Byte == "comok"[Matched])
+                {
+                    Matched++;
+                }
+                else
+                {
+                    Matched = (Byte == 'c') ? 1 : 0;
+                }
+            }
+            else if (Byte == 0xFF && ++Terminator_Count == 3) // -- Consume the whole answer.
             {
-                Nextion_Serial.read();
-                vTaskDelay(pdMS_TO_TICKS(1));
+                return true;
             }
-            break;
         }
+        Transport->Wait_For_Data(Time_Out - (millis() - Start_Time) + 1);
+    }
+    return Matched == 5;
+}
 
-        vTaskDelay(pdMS_TO_TICKS(1));
+///
+/// @brief Store the baud rate the display answered at, so that it is tried first by the next discovery.
+///
+void Nextion_Class::Save_Baud_Rate(uint32_t Baud_Rate)
+{
+#if Nextion_Baud_Rate_Persistence
+    Preferences Storage;
+    if (Storage.begin("Nextion", false))
+    {
+        if (Storage.getUInt("Baud_Rate", 0) != Baud_Rate) // -- Spare the flash.
+        {
+            Storage.putUInt("Baud_Rate", Baud_Rate);
+        }
+        Storage.end();
     }
+#else
+    (void)Baud_Rate;
+#endif
+}
+
+///
+/// @brief Upload the file, using the resumable protocol (whmi-wris) when the display supports it.
+/// @details With the resumable protocol, the display reports the offset of the data it already holds, so a failed transfer is resumed instead of restarted.
+///
+uint8_t Nextion_Class::Upload(File &Update_File, uint8_t *Buffers)
+{
+    uint32_t Phase_Start = millis();
+    uint32_t Update_Baud_Rate;
 
-    Nextion_Serial.print(F("dim=100\xFF\xFF\xFF"));
-    Nextion_Serial.print(F("ussp=0\xFF\xFF\xFF"));
-    Nextion_Serial.print(F("thsp=0\xFF\xFF\xFF"));
+    if (!Connect(Update_Baud_Rate))
+    {
+        return Update_Failed;
+    }
 
-    Nextion_Serial.print(F("whmi-wri "));
-    Nextion_Serial.print(Update_File.size());
-    Argument_Separator();
-    Nextion_Serial.print(Baud_Rate[i]);
-    Argument_Separator();
-    Nextion_Serial.print(F("0\xFF\xFF\xFF"));
+    Update_Statistics.Probing_Time = millis() - Phase_Start;
 
-    char Temporary_Buffer[4096];
-    memset(Temporary_Buffer, '\0', sizeof(Temporary_Buffer));
+    bool Resumable = true;
 
-    while (Update_File.available() >= 4096)
+    for (uint8_t Attempt = 0; Attempt < Nextion_Update_Attempts; Attempt++)
     {
-        if (Update_File.readBytes(Temporary_Buffer, sizeof(Temporary_Buffer)) != 4096)
+        Update_Statistics.Attempts++;
+
+        if (Attempt != 0)
         {
-            return Update_Failed;
+            Phase_Start = millis();
+            if (!Connect(Update_Baud_Rate))
+            {
+                return Update_Failed;
+            }
+            Update_Statistics.Probing_Time += millis() - Phase_Start;
+        }
+
+        Phase_Start = millis();
+
+        Instruction_Append(F("dim=100\xFF\xFF\xFF"));
+        Instruction_Append(F("ussp=0\xFF\xFF\xFF"));
+        Instruction_Append(F("thsp=0\xFF\xFF\xFF"));
+
+        if (Resumable)
+        {
+            Instruction_Append(F("whmi-wris "));
+            Instruction_Append_Number(Update_File.size());
+            Argument_Separator();
+            Instruction_Append_Number(Update_Baud_Rate);
+            Argument_Separator();
+            Instruction_Append('1');
+            Instruction_Send();
+
+            // -- Displays that do not know the resumable protocol do not answer : fall back to whmi-wri.
+            Resumable = Wait_For_Update_Acknowledge(500);
+            if (!Resumable)
+            {
+                Instruction_Append(F("DRAKJHSUYDGBNCJHGJKSHBDN"));
+                Instruction_Send();
+            }
         }
 
-        Timeout = millis() + 3000;
-        while (Nextion_Serial.read() != 0x05)
+        if (!Resumable)
         {
-            if (millis() > Timeout)
+            Instruction_Append(F("whmi-wri "));
+            Instruction_Append_Number(Update_File.size());
+            Argument_Separator();
+            Instruction_Append_Number(Update_Baud_Rate);
+            Argument_Separator();
+            Instruction_Append('0');
+            Instruction_Send();
+
+            if (!Wait_For_Update_Acknowledge(3000))
             {
                 return Update_Failed;
             }
         }
 
-        Nextion_Serial.write(Temporary_Buffer, sizeof(Temporary_Buffer));
+        Update_Statistics.Handshake_Time += millis() - Phase_Start;
+        Phase_Start = millis();
+
+        bool Succeed = Transfer(Update_File, Buffers);
 
-        vTaskDelay(pdMS_TO_TICKS(1));
+        Update_Statistics.Transfer_Time += millis() - Phase_Start;
+
+        if (Succeed)
+        {
+            return Update_Succeed;
+        }
+        if (!Resumable) // -- A legacy transfer cannot be resumed.
+        {
+            return Update_Failed;
+        }
     }
 
-    memset(Temporary_Buffer, '\0', sizeof(Temporary_Buffer));
+    return Update_Failed;
+}
+
+///
+/// @brief Send the file from its beginning, skipping the data the display reports it already holds.
+/// @details The next chunk is read while the display receives and stores the current one.
+///
+bool Nextion_Class::Transfer(File &Update_File, uint8_t *Buffers)
+{
+    uint32_t File_Size = Update_File.size();
+    uint32_t Position = 0;
+    uint32_t Start_Time = millis();
+    uint32_t Sent_Bytes = 0;
 
-    uint16_t Remaining_Bytes = Update_File.available();
+    uint8_t *Current_Buffer = Buffers;
+    uint8_t *Next_Buffer = Buffers + Update_Chunk_Size;
+    uint32_t Chunk_Size = (File_Size < Update_Chunk_Size) ? File_Size : Update_Chunk_Size;
 
-    Update_File.readBytes(Temporary_Buffer, Remaining_Bytes);
+    if (!Update_File.seek(0) || Update_File.read(Current_Buffer, Chunk_Size) != Chunk_Size)
+    {
+        return false;
+    }
 
-    Timeout = millis() + 3000;
-    while (Nextion_Serial.read() != 0x05)
+    while (Chunk_Size != 0)
     {
-        if (millis() > Timeout)
+        Write_Transport(Current_Buffer, Chunk_Size);
+        Position += Chunk_Size;
+        Sent_Bytes += Chunk_Size;
+        Update_Statistics.Sent_Bytes += Chunk_Size;
+
+        // -- Read the next chunk while the current one is being received and stored by the display.
+        uint32_t Next_Chunk_Size = File_Size - Position;
+        if (Next_Chunk_Size > Update_Chunk_Size)
         {
-            return Update_Failed;
+            Next_Chunk_Size = Update_Chunk_Size;
+        }
+        if (Next_Chunk_Size != 0 && Update_File.read(Next_Buffer, Next_Chunk_Size) != Next_Chunk_Size)
+        {
+            return false;
+        }
+
+        uint32_t Offset = 0;
+        if (!Wait_For_Update_Acknowledge(3000, &Offset))
+        {
+            return false;
+        }
+
+        // -- The display already holds the data up to Offset : skip it.
+        if (Offset > Position && Offset <= File_Size)
+        {
+            Update_Statistics.Skipped_Bytes += Offset - Position;
+            Position = Offset;
+            Next_Chunk_Size = File_Size - Position;
+            if (Next_Chunk_Size > Update_Chunk_Size)
+            {
+                Next_Chunk_Size = Update_Chunk_Size;
+            }
+            if (!Update_File.seek(Position) || (Next_Chunk_Size != 0 && Update_File.read(Next_Buffer, Next_Chunk_Size) != Next_Chunk_Size))
+            {
+                return false;
+            }
         }
+
+        uint32_t Elapsed_Time = millis() - Start_Time;
+        Callback_Function_Update_Progress(Position, File_Size, Elapsed_Time ? (uint64_t)Sent_Bytes * 1000 / Elapsed_Time : 0);
+
+        uint8_t *Swap_Buffer = Current_Buffer;
+        Current_Buffer = Next_Buffer;
+        Next_Buffer = Swap_Buffer;
+        Chunk_Size = Next_Chunk_Size;
     }
 
-    Nextion_Serial.write(Temporary_Buffer, Remaining_Bytes);
+    return true;
+}
 
-    Timeout = millis() + 3000;
-    while (Nextion_Serial.read() != 0x05)
+///
+/// @brief Wait for the display to acknowledge an update chunk (0x05), or to report the offset to resume from (0x08 followed by a 4 bytes little endian offset).
+///
+/// @param Time_Out Maximum time to wait (in milliseconds).
+/// @param Offset Set to the reported offset, if any.
+/// @return true if the display acknowledged, false on timeout.
+bool Nextion_Class::Wait_For_Update_Acknowledge(uint32_t Time_Out, uint32_t *Offset)
+{
+    uint32_t Start_Time = millis();
+    uint32_t Elapsed_Time;
+    while ((Elapsed_Time = millis() - Start_Time) <= Time_Out)
     {
-        if (millis() > Timeout)
+        switch (Transport->Read_Byte())
         {
-            return Update_Failed;
+        case -1:
+            Transport->Wait_For_Data(Time_Out - Elapsed_Time + 1);
+            break;
+        case 0x05:
+            return true;
+        case 0x08:
+            while (Transport->Available() < 4)
+            {
+                Elapsed_Time = millis() - Start_Time;
+                if (Elapsed_Time > Time_Out)
+                {
+                    return false;
+                }
+                Transport->Wait_For_Data(Time_Out - Elapsed_Time + 1);
+            }
+            uint8_t Bytes[4];
+            Transport->Read(Bytes, 4);
+            if (Offset != NULL)
+            {
+                *Offset = ((uint32_t)Bytes[3] << 24) | ((uint32_t)Bytes[2] << 16) | ((uint32_t)Bytes[1] << 8) | Bytes[0];
+            }
+            return true;
         }
     }
-
-    return Update_Succeed;
+    return false;
 }
 
 // Sleep & Wake up
 
 void Nextion_Class::Sleep()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("sleep=1"));
+    Instruction_Start();
+    Instruction_Append(F("sleep=1"));
     Instruction_End();
 }
 
 void Nextion_Class::Wake_Up()
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("sleep=0"));
+    Instruction_Start();
+    Instruction_Append(F("sleep=0"));
     Instruction_End();
 }
 
-void Nextion_Class::Get(const __FlashStringHelper *Attribute)
+void Nextion_Class::Get(const char *Attribute)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("get "));
-    Nextion_Serial.print(Attribute);
+    Instruction_Start();
+    Frame_Type = Frame_Query;
+    Instruction_Append(F("get "));
+    Instruction_Append(Attribute);
     Instruction_End();
 }
 
 void Nextion_Class::Clear(uint16_t Color)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("cls "));
-    Nextion_Serial.print(Color);
+    Instruction_Start();
+    Instruction_Append(F("cls "));
+    Instruction_Append_Number(Color);
     Instruction_End();
 }
 
 void Nextion_Class::Set_Drawing(bool Enable)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("thdra="));
-    Nextion_Serial.print(Enable);
+    Instruction_Start();
+    Instruction_Append(F("thdra="));
+    Instruction_Append_Number(Enable);
     Instruction_End();
 }
 
 void Nextion_Class::Set_Draw_Color(uint16_t Color)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("thc="));
-    Nextion_Serial.print(Color);
+    Instruction_Start();
+    Instruction_Append(F("thc="));
+    Instruction_Append_Number(Color);
     Instruction_End();
 }
 
@@ -1397,50 +3396,51 @@ void Nextion_Class::Set_Random_Generator(int32_t Minimum, int32_t Maximum)
     {
         return;
     }
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
-    Nextion_Serial.print(F("randset "));
-    Nextion_Serial.print(Minimum);
+    Instruction_Start();
+    Instruction_Append(F("randset "));
+    Instruction_Append_Signed_Number(Minimum);
     Argument_Separator();
-    Nextion_Serial.print(Maximum);
+    Instruction_Append_Signed_Number(Maximum);
     Instruction_End();
 }
 
 void Nextion_Class::Set_Display_Baud_Rate(uint32_t Baud_Rate, bool Save)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
     if (Baud_Rate > 921000)
     {
         return;
     }
-    Nextion_Serial.print(F("baud"));
+    Instruction_Start();
+    Instruction_Append(F("baud"));
     if (Save)
     {
-        Nextion_Serial.print(F("s"));
+        Instruction_Append(F("s"));
     }
-    Nextion_Serial.print(F("="));
-    Nextion_Serial.print(Baud_Rate);
+    Instruction_Append(F("="));
+    Instruction_Append_Number(Baud_Rate);
     Instruction_End();
 }
 
 void Nextion_Class::Set_Baud_Rate(uint32_t Baud_Rate)
 {
-    Nextion_Serial.updateBaudRate(Baud_Rate);
+    this->Baud_Rate = Baud_Rate;
+    Transport->Set_Baud_Rate(Baud_Rate);
 }
 
 void Nextion_Class::Set_Brightness(uint16_t Brightness, bool Save)
 {
-    xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
     if (Brightness > 100)
     {
         return;
     }
+    Instruction_Start();
 
-    Nextion_Serial.print(F("dim"));
+    Instruction_Append(F("dim"));
     if (Save)
     {
-        Nextion_Serial.print(F("s"));
+        Instruction_Append(F("s"));
     }
-    Nextion_Serial.print(F("="));
-    Nextion_Serial.print(Brightness);
+    Instruction_Append(F("="));
+    Instruction_Append_Number(Brightness);
     Instruction_End();
 }
\ No newline at end of file
@@ -12,10 +12,16 @@
 #define NEXTION_LIBRARY_H_INCLUDED
 
 #include "Arduino.h"
-#include "HardwareSerial.h"
+#include <new>
+#include <stdarg.h>
+#include "Nextion_Transport.hpp"
+#include "freertos/ringbuf.h"
 #include "FS.h"
+#include "Preferences.h"
 #include "Configuration.hpp"
-#include "ArduinoTrace.h"
+#include "Nextion_Decimation.hpp"
+#include "Nextion_Encoding.hpp"
+#include "Nextion_Component.hpp"
 
 class Nextion_Class
 {
@@ -95,18 +101,93 @@ public:
         None = 3
     };
 
+    typedef struct
+    {
+        uint32_t Probing_Time;   // -- Time spent finding the display baud rate (in milliseconds).
+        uint32_t Handshake_Time; // -- Time spent until the display is ready to receive the file (in milliseconds).
+        uint32_t Transfer_Time;  // -- Time spent sending the file (in milliseconds).
+        uint32_t Sent_Bytes;
+        uint32_t Skipped_Bytes; // -- Bytes the display already had (resumable protocol only).
+        uint8_t Attempts;
+    } Update_Statistics_Type;
+
+    typedef struct
+    {
+        uint32_t Sent_Bytes;
+        uint32_t Sent_Frames;
+        uint32_t Received_Bytes;
+        uint32_t Received_Frames;
+        uint32_t Semaphore_Contentions; // -- Instructions that had to wait for the serial semaphore.
+        uint32_t Semaphore_Wait_Time;   // -- Total time spent waiting for it (in microseconds).
+        uint32_t Return_Codes[Serial_Buffer_Overflow + 1]; // -- Received return codes, indexed by code (0x00 invalid instruction, 0x01 success, then errors).
+        uint32_t Resynchronizations; // -- Malformed frames dropped and purges.
+        uint32_t Truncated_Bytes;    // -- Payload bytes dropped because a frame was too long.
+        uint32_t Receive_Overflows;  // -- Overflows of the transport receive buffer.
+        uint32_t Dropped_Callbacks;  // -- Callbacks not called because the callback queue was full.
+        uint32_t Dropped_Frames;     // -- Frames dropped from the transmit queue by Queue_Drop_Oldest or Queue_Fail.
+        uint32_t Time_Outs;          // -- Round trips without response, and instructions lost in acknowledged mode.
+        // -- Latency histograms : bucket 0 counts latencies of 0 us, bucket n those in [2^(n-1), 2^n[ us, the last one everything above.
+        uint32_t Request_Latency[Nextion_Statistics_Histogram_Size];     // -- Synchronous requests (sendme, get ...).
+        uint32_t Transparent_Latency[Nextion_Statistics_Histogram_Size]; // -- Transparent mode ready / finished events.
+        uint32_t Acknowledge_Latency[Nextion_Statistics_Histogram_Size]; // -- Instructions acknowledged in acknowledged mode.
+    } Statistics_Type;
+
+    enum Command_Statuses
+    {
+        Command_Pending = 0xF0,
+        Command_Lost = 0xF1,
+        Command_Unknown = 0xF2,
+        Command_Dropped = 0xF3 // -- Dropped from the transmit queue, never sent.
+    };
+
+    enum Queue_Policies
+    {
+        Queue_Block = 0,
+        Queue_Drop_Oldest = 1,
+        Queue_Fail = 2
+    };
+
     // -- Methods
 
-    void Begin(uint32_t Baud_Rate = 921600, uint8_t RX_Pin = 16, uint8_t TX_Pin = 17);
+#ifdef ARDUINO
+    void Begin(uint32_t Baud_Rate = 921600, uint8_t RX_Pin = 16, uint8_t TX_Pin = 17, bool Discover_Baud_Rate = false);
+#endif
+    void Begin(Nextion_Transport_Class &Transport, uint32_t Baud_Rate, bool Discover_Baud_Rate = false);
+
+    // -- Asynchronous transmission
+
+    bool Set_Asynchronous_Transmission(bool Enable, size_t Queue_Size = 2048, Queue_Policies Policy = Queue_Block, UBaseType_t Priority = 2, uint32_t Stack_Size = 2048);
+    bool Flush(uint32_t Time_Out = portMAX_DELAY);
+
+    // -- Batches
+
+    void Begin_Batch(bool Freeze_Refresh = false);
+    void Commit_Batch();
+
+    // -- Acknowledged mode
+
+    bool Set_Acknowledged_Mode(bool Enable, uint8_t Window = 4);
+    uint32_t Get_Last_Command();
+    uint8_t Get_Command_Status(uint32_t Command);
+
+    // -- Shadow cache
+
+    bool Set_Shadow_Cache(uint8_t Size);
+    void Invalidate_Shadow_Cache();
 
     // -- Loop process
 
     void Loop();
+    void Set_Loop_Budget(uint16_t Maximum_Bytes, uint32_t Maximum_Time = 0);
+
+    bool Set_Receive_Task(bool Enable, UBaseType_t Priority = 5, uint32_t Stack_Size = 4096, BaseType_t Core = tskNO_AFFINITY);
 
     // -- Default call back functions
     static void Default_Callback_Function_String_Data(const char *, uint8_t);
     static void Default_Callback_Function_Numeric_Data(uint32_t);
     static void Default_Callback_Function_Event(uint8_t);
+    static void Default_Callback_Function_Acknowledge(uint32_t, uint8_t);
+    static void Default_Callback_Function_Update_Progress(uint32_t, uint32_t, uint32_t);
 
     // -- Drawing
 
@@ -118,51 +199,72 @@ public:
     void Draw_Picture(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID);
     void Draw_Crop_Picture(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Picture_ID);
     void Draw_Advanced_Crop_Picture(uint16_t X_Destination, uint16_t Y_Destination, uint16_t Width, uint16_t Height, uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Picture_ID);
-    void Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, String const &Text);
     void Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, const char *Text);
+    void Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, const char *Text, size_t Size);
 
     // -- Set object attributes methods
     void Set_Font(const __FlashStringHelper *Object_Name, uint8_t Font_ID);
+    void Set_Font(const char *Object_Name, uint8_t Font_ID);
     void Set_Background_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type = -1);
+    void Set_Background_Color(const char *Object_Name, uint16_t Color, int8_t Type = -1);
     void Set_Font_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type = -1);
+    void Set_Font_Color(const char *Object_Name, uint16_t Color, int8_t Type = -1);
     void Set_Horizontal_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment);
+    void Set_Horizontal_Alignment(const char *Object_Name, uint8_t Alignment);
     void Set_Vertical_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment);
+    void Set_Vertical_Alignment(const char *Object_Name, uint8_t Alignment);
 
     void Set_Mask(const __FlashStringHelper *Object_Name, bool Masked);
+    void Set_Mask(const char *Object_Name, bool Masked);
     void Set_Wordwrap(const __FlashStringHelper *Object_Name, bool Wordwrap);
+    void Set_Wordwrap(const char *Object_Name, bool Wordwrap);
 
+    void Set_Text(const __FlashStringHelper *Object_Name, const char *Value);
     void Set_Text(const __FlashStringHelper *Object_Name, char Value);
     void Set_Text(const __FlashStringHelper *Object_Name, const __FlashStringHelper *Value);
-    void Set_Text(String const &Object_Name, String const &Value);
     void Set_Text(const char *Object_Name, const char *Value);
-    void Set_Text(const __FlashStringHelper *Object_Name, const char *Value);
+    void Set_Text(const char *Object_Name, const char *Value, size_t Size);
+    bool Set_Text_Format(const __FlashStringHelper *Object_Name, const char *Format, ...) __attribute__((format(printf, 3, 4)));
+    bool Set_Text_Format(const char *Object_Name, const char *Format, ...) __attribute__((format(printf, 3, 4)));
 
-    void Add_Text(const __FlashStringHelper *Component_Name, const char *Data);
+    void Add_Text(const __FlashStringHelper *Object_Name, const char *Data);
     void Add_Text(const __FlashStringHelper *Object_Name, char Data);
+    void Add_Text(const char *Object_Name, const char *Data);
+    void Add_Text(const char *Object_Name, const char *Data, size_t Size);
 
-    void Delete_Text(const __FlashStringHelper *Component_Name, uint8_t Quantity);
+    void Delete_Text(const __FlashStringHelper *Object_Name, uint8_t Quantity);
+    void Delete_Text(const char *Object_Name, uint8_t Quantity);
 
     void Set_Maximum_Value(const __FlashStringHelper *Object_Name, uint16_t Value);
+    void Set_Maximum_Value(const char *Object_Name, uint16_t Value);
 
     void Set_Minimum_Value(const __FlashStringHelper *Object_Name, uint16_t Value);
+    void Set_Minimum_Value(const char *Object_Name, uint16_t Value);
 
     void Set_Value(const __FlashStringHelper *Object_Name, uint32_t Value);
-    void Set_Value(String const &Object_Name, uint32_t Value);
     void Set_Value(const char *Object_Name, uint32_t Value);
 
     void Set_Global_Variable(const __FlashStringHelper *Object_Name, uint32_t Value);
+    void Set_Global_Variable(const char *Object_Name, uint32_t Value);
 
     void Set_Channel_Color(const __FlashStringHelper *Object_Name, uint8_t Channel_ID, uint16_t Color);
+    void Set_Channel_Color(const char *Object_Name, uint8_t Channel_ID, uint16_t Color);
     void Set_Grid_Color(const __FlashStringHelper *Object_Name, uint16_t Color);
+    void Set_Grid_Color(const char *Object_Name, uint16_t Color);
     void Set_Grid_Width(const __FlashStringHelper *Object_Name, uint16_t Width);
+    void Set_Grid_Width(const char *Object_Name, uint16_t Width);
     void Set_Grid_Height(const __FlashStringHelper *Object_Name, uint16_t Height);
+    void Set_Grid_Height(const char *Object_Name, uint16_t Height);
     void Set_Data_Scaling(const __FlashStringHelper *Object_Name, uint16_t Scale);
+    void Set_Data_Scaling(const char *Object_Name, uint16_t Scale);
 
     void Set_Picture(const __FlashStringHelper *Object_Name, uint8_t Picture_ID);
-    void Set_Picture(String const &Object_Name, uint8_t Picture_ID);
+    void Set_Picture(const char *Object_Name, uint8_t Picture_ID);
 
     void Set_Time(const __FlashStringHelper *Object_Name, uint16_t Time);
+    void Set_Time(const char *Object_Name, uint16_t Time);
     void Set_Trigger(const __FlashStringHelper *Object_Name, bool Enable);
+    void Set_Trigger(const char *Object_Name, bool Enable);
 
     void Set_Reparse_Mode(uint8_t Mode);
 
@@ -201,8 +303,8 @@ public:
 
     void Write(int Data);
     void Send_Raw(const __FlashStringHelper *Data);
-    void Send_Raw(String const &Data);
     void Send_Raw(const char *Data);
+    void Send_Raw(const char *Data, size_t Size);
 
     void Purge();
 
@@ -223,21 +325,30 @@ public:
     void Set_Waveform_Refresh(bool Enable);
 
     void Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, uint8_t *Data, uint32_t Quantity = 0);
+    void Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint32_t Quantity, uint16_t Width, uint8_t Minimum = 0, uint8_t Maximum = 255);
+    void Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const int16_t *Data, uint32_t Quantity, uint16_t Width, int16_t Minimum, int16_t Maximum);
+    void Add_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const float *Data, uint32_t Quantity, uint16_t Width, float Minimum, float Maximum);
     void Clear_Waveform(uint16_t Component_ID, uint8_t Channel);
 
+    bool Add_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, uint16_t Capacity = 256, uint16_t Flush_Size = 128, uint32_t Flush_Age = 100, uint8_t Page_ID = 0xFF);
+    void Remove_Waveform_Stream(uint8_t Component_ID, uint8_t Channel);
+    bool Push_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, uint8_t Value);
+    bool Push_Waveform_Stream(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint16_t Quantity);
+    void Flush_Waveform_Streams();
+
     void Get(const __FlashStringHelper *Attribute);
+    void Get(const char *Attribute);
 
     void Calibrate();
 
     void Show(const __FlashStringHelper *Object_Name);
-    void Show(String const &Object_Name);
     void Show(const char *Object_Name);
 
     void Hide(const __FlashStringHelper *Object_Name);
-    void Hide(String const &Object_Name);
     void Hide(const char *Object_Name);
 
     void Set_Touch_Event(const __FlashStringHelper *Object_Name, bool Enable);
+    void Set_Touch_Event(const char *Object_Name, bool Enable);
     void Set_Touch_Event(uint8_t Object_ID, bool Enable);
 
     void Set_Execution(bool Enable);
@@ -245,6 +356,66 @@ public:
     void Reboot();
 
     uint8_t Update(File Update_File);
+    Update_Statistics_Type Get_Update_Statistics();
+
+    // -- Component handles
+
+    void Set_Value(Nextion_Number_Class const &Number, uint32_t Value);
+    void Set_Value(Nextion_Progress_Bar_Class const &Progress_Bar, uint8_t Value);
+    void Set_Text(Nextion_Text_Class const &Text, const char *Value);
+    void Add_Text(Nextion_Text_Class const &Text, const char *Data);
+    void Set_Picture(Nextion_Picture_Class const &Picture, uint8_t Picture_ID);
+    void Add_Value_Waveform(Nextion_Waveform_Class const &Waveform, uint8_t Value);
+    void Add_Value_Waveform(Nextion_Waveform_Class const &Waveform, uint8_t *Data, uint32_t Quantity);
+    void Clear_Waveform(Nextion_Waveform_Class const &Waveform);
+    void Show(Nextion_Component_Class const &Component);
+    void Hide(Nextion_Component_Class const &Component);
+
+#if Nextion_String_Overloads
+    // -- Arduino String overloads
+
+    void Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, String const &Text);
+    void Set_Font(String const &Object_Name, uint8_t Font_ID);
+    void Set_Background_Color(String const &Object_Name, uint16_t Color, int8_t Type = -1);
+    void Set_Font_Color(String const &Object_Name, uint16_t Color, int8_t Type = -1);
+    void Set_Horizontal_Alignment(String const &Object_Name, uint8_t Alignment);
+    void Set_Vertical_Alignment(String const &Object_Name, uint8_t Alignment);
+    void Set_Mask(String const &Object_Name, bool Masked);
+    void Set_Wordwrap(String const &Object_Name, bool Wordwrap);
+    void Set_Text(String const &Object_Name, const char *Value);
+    void Set_Text(String const &Object_Name, String const &Value);
+    void Add_Text(String const &Object_Name, const char *Data);
+    void Delete_Text(String const &Object_Name, uint8_t Quantity);
+    void Set_Maximum_Value(String const &Object_Name, uint16_t Value);
+    void Set_Minimum_Value(String const &Object_Name, uint16_t Value);
+    void Set_Value(String const &Object_Name, uint32_t Value);
+    void Set_Global_Variable(String const &Object_Name, uint32_t Value);
+    void Set_Channel_Color(String const &Object_Name, uint8_t Channel_ID, uint16_t Color);
+    void Set_Grid_Color(String const &Object_Name, uint16_t Color);
+    void Set_Grid_Width(String const &Object_Name, uint16_t Width);
+    void Set_Grid_Height(String const &Object_Name, uint16_t Height);
+    void Set_Data_Scaling(String const &Object_Name, uint16_t Scale);
+    void Set_Picture(String const &Object_Name, uint8_t Picture_ID);
+    void Set_Time(String const &Object_Name, uint16_t Time);
+    void Set_Trigger(String const &Object_Name, bool Enable);
+    void Send_Raw(String const &Data);
+    void Refresh(String const &Object_Name);
+    void Click(String const &Object_Name, uint8_t Event_Type);
+    void Get(String const &Attribute);
+    void Show(String const &Object_Name);
+    void Hide(String const &Object_Name);
+    void Set_Touch_Event(String const &Object_Name, bool Enable);
+#endif
+
+    // -- Statistics
+
+    Statistics_Type Get_Statistics();
+    void Reset_Statistics();
+
+    // -- Protocol trace
+
+    size_t Dump_Trace(uint8_t *Buffer, size_t Size);
+    void Clear_Trace();
 
     // -- Setter methods
     void Set_Address(uint16_t Address);
@@ -253,6 +424,8 @@ public:
     void Set_Callback_Function_String_Data(void (*Function_Pointer)(const char *, uint8_t));
     void Set_Callback_Function_Numeric_Data(void (*Function_Pointer)(uint32_t));
     void Set_Callback_Function_Event(void (*Function_Pointer)(uint8_t));
+    void Set_Callback_Function_Acknowledge(void (*Function_Pointer)(uint32_t, uint8_t));
+    void Set_Callback_Function_Update_Progress(void (*Function_Pointer)(uint32_t, uint32_t, uint32_t));
 
     // -- Getter methods
     uint16_t Get_Address();
@@ -260,71 +433,347 @@ public:
 protected:
     // -- Methods
 
-    inline void Instruction_End()
+    ///
+    /// @brief Take the serial semaphore, measuring the time spent waiting for it when it is not free.
+    ///
+    inline void Take_Serial_Semaphore()
     {
-        Nextion_Serial.write(0xFF);
-        Nextion_Serial.write(0xFF);
-        Nextion_Serial.write(0xFF);
-        xSemaphoreGive(Serial_Semaphore);
+        // -- The task filling a batch already holds it.
+        if (Batch_Task == xTaskGetCurrentTaskHandle())
+        {
+            return;
+        }
+#if Nextion_Statistics
+        if (xSemaphoreTake(Serial_Semaphore, 0) != pdTRUE)
+        {
+            uint32_t Start_Time = micros();
+            xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
+            Statistics.Semaphore_Contentions++;
+            Statistics.Semaphore_Wait_Time += micros() - Start_Time;
+        }
+#else
+        xSemaphoreTake(Serial_Semaphore, portMAX_DELAY);
+#endif
     }
 
-    inline void Argument_Separator()
+    ///
+    /// @brief Give the serial semaphore back, unless a batch is being filled. The serial semaphore must be held.
+    ///
+    inline void Give_Serial_Semaphore()
     {
-        Nextion_Serial.write(',');
+        if (Batch_Task == NULL)
+        {
+            xSemaphoreGive(Serial_Semaphore);
+        }
     }
 
-    inline bool Ending(char *String)
+    void Write_Transport(const uint8_t *Data, size_t Size);
+
+    // -- Instruction frame builder
+
+    ///
+    /// @brief Take the serial semaphore and start a new instruction frame.
+    /// @details In a batch, the instruction is appended after the previous ones.
+    ///
+    inline void Instruction_Start()
     {
-        if (String[0] == 0xFF && String[1] == 0xFF && String[2] == 0xFF)
+        Take_Serial_Semaphore();
+        if (Batch_Task == NULL)
         {
-            return true;
+            Frame_Size = 0;
         }
-        return false;
+        Instruction_Offset = Frame_Size;
+        Frame_Chunked = false;
+        Frame_Type = Frame_Command;
     }
 
-    inline bool Wait_For_Event(uint8_t Expected_Event, uint32_t Time_Out = 500)
+    inline void Instruction_Append(char Character)
     {
-        Time_Out = Time_Out + millis();
-        while (this->Expected_Event != 0xFF && this->Expected_Event != Expected_Event)
+        if (Frame_Size >= sizeof(Frame_Buffer))
         {
-            if (Time_Out < millis())
-            {
-                return false;
-            }
-            vTaskDelay(pdMS_TO_TICKS(20));
+            Frame_Chunked = true;
+            Instruction_Flush();
         }
+        Frame_Buffer[Frame_Size++] = (uint8_t)Character;
+    }
+
+    inline void Instruction_Append(const __FlashStringHelper *Text)
+    {
+        Instruction_Append(reinterpret_cast<const char *>(Text));
+    }
+
+#if Nextion_String_Overloads
+    inline void Instruction_Append(String const &Text)
+    {
+        Instruction_Append((const uint8_t *)Text.c_str(), Text.length());
+    }
+#endif
+
+    inline void Instruction_Append(Nextion_Prefix_Type const &Prefix)
+    {
+        Instruction_Append((const uint8_t *)Prefix.Data, Prefix.Size);
+    }
+
+    void Instruction_Append(const char *Text);
+    void Instruction_Append(const uint8_t *Data, size_t Size);
+    void Instruction_Append_Number(uint32_t Number);
+    void Instruction_Append_Signed_Number(int32_t Number);
+    void Instruction_Append_Escaped(const char *Text, size_t Size);
+    bool Instruction_Append_Format(const char *Format, va_list Arguments);
+
+    inline void Instruction_Append_Escaped(const char *Text)
+    {
+        Instruction_Append_Escaped(Text, strlen(Text));
+    }
+
+    inline void Argument_Separator()
+    {
+        Instruction_Append(',');
+    }
+
+    bool Instruction_Flush();
+
+    ///
+    /// @brief Terminate the instruction, without sending it.
+    ///
+    inline void Instruction_Terminate()
+    {
+        Instruction_Append('\xFF');
+        Instruction_Append('\xFF');
+        Instruction_Append('\xFF');
+#if Nextion_Statistics
+        Statistics.Sent_Frames++;
+#endif
+    }
+
+    ///
+    /// @brief Terminate the frame and send it (along with the batched instructions), without releasing the serial semaphore.
+    ///
+    inline void Instruction_Send()
+    {
+        Instruction_Terminate();
+        Instruction_Flush();
+    }
 
-        this->Expected_Event = Expected_Event;
-        State = false;
+    ///
+    /// @brief Send an internal frame (Frame_Transparent or Frame_Reset) : in acknowledged mode, it holds a place in the window so that its reply is not matched with another instruction.
+    ///
+    inline void Instruction_Send(uint8_t Type)
+    {
+        Frame_Type = Type;
+        if (Window_Semaphore != NULL)
+        {
+            Track_Command();
+        }
+        Instruction_Send();
+    }
 
-        while (State == false)
+    inline void Instruction_End()
+    {
+        if (Window_Semaphore != NULL && Frame_Type != Frame_Untracked)
         {
-            if (Expected_Event != Expected_Event || Time_Out < millis())
-            {
-                State = false;
-                this->Expected_Event = 0xFF;
-                return false;
-            }
-            vTaskDelay(pdMS_TO_TICKS(20));
+            Track_Command();
         }
+        Instruction_Terminate();
+        // -- A batched instruction waits for the commit, unless its caller waits for the answer.
+        if (Batch_Task == NULL || Frame_Type == Frame_Query)
+        {
+            Instruction_Flush();
+        }
+        Give_Serial_Semaphore();
+    }
+
+    void Instruction_End_Cached(uint16_t Key_Size);
+
+    bool Set_Text_Format_Arguments(const char *Object_Name, const char *Format, va_list Arguments);
+
+    // -- Receive parser
+
+    enum Parser_States
+    {
+        Parser_Idle,
+        Parser_Fixed_Payload,
+        Parser_Variable_Payload,
+        Parser_Terminator,
+        Parser_Resynchronize
+    };
+
+    enum Callback_Types
+    {
+        Callback_String_Data,
+        Callback_Numeric_Data,
+        Callback_Event,
+        Callback_Acknowledge
+    };
+
+    void Process(uint16_t Maximum_Bytes, uint32_t Maximum_Time, TickType_t Time_Out);
+    size_t Receive(uint16_t Maximum_Bytes, uint32_t Maximum_Time, bool Waiting);
+    void Parse(uint8_t Byte);
+    void Dispatch();
+    void Queue_Callback(uint8_t Type, uint32_t Value, uint8_t Status = 0);
+    bool Run_Callbacks();
+
+    static void Receive_Task(void *Instance);
+
+    // -- Acknowledged mode
+
+    enum Frame_Types
+    {
+        Frame_Command,     // -- Acknowledged by 0x01 or an error code.
+        Frame_Query,       // -- Acknowledged by the returned data or an error code.
+        Frame_Transparent, // -- addt header, acknowledged by 0xFE or an error code. Internal : not reported.
+        Frame_Reset,       // -- DRAKJHSUYDGBNCJHGJKSHBDN, answered by 0x00 unless swallowed as transparent data. Internal : not reported.
+        Frame_Untracked,   // -- Not acknowledged.
+    };
+
+    void Track_Command(uint32_t Cache_Key = 0);
+    void Acknowledge_Command(uint8_t Status, uint8_t Reply_Type = Frame_Command);
+    void Complete_Command(uint8_t Status);
+
+    // -- Update
+
+    bool Connect(uint32_t &Baud_Rate);
+    bool Probe(uint32_t Baud_Rate);
+    void Save_Baud_Rate(uint32_t Baud_Rate);
+    uint8_t Upload(File &Update_File, uint8_t *Buffers);
+    bool Transfer(File &Update_File, uint8_t *Buffers);
+    bool Wait_For_Update_Acknowledge(uint32_t Time_Out, uint32_t *Offset = NULL);
+
+    // -- Waveform streams
+
+    typedef struct
+    {
+        uint8_t *Samples; // -- NULL when the stream is free.
+        uint16_t Capacity;
+        uint16_t Head;    // -- Index of the next sample.
+        uint16_t Count;   // -- Samples kept in history.
+        uint16_t Pending; // -- Samples not sent yet.
+        uint16_t Flush_Size;
+        uint32_t Flush_Age;
+        uint32_t Oldest_Pending_Time;
+        uint8_t Component_ID;
+        uint8_t Channel;
+        uint8_t Page_ID;       // -- Page owning the waveform, 0xFF if unknown.
+        volatile bool Backfill; // -- The history must be sent again (page re-entry).
+    } Waveform_Stream_Type;
+
+    Waveform_Stream_Type *Find_Waveform_Stream(uint8_t Component_ID, uint8_t Channel);
+    bool Is_Waveform_Stream_Visible(Waveform_Stream_Type const &Stream);
+    void Send_Waveform_Stream(Waveform_Stream_Type &Stream, uint16_t Size);
+    void Flush_Waveform_Stream(Waveform_Stream_Type &Stream);
+    void Backfill_Waveform_Stream(Waveform_Stream_Type &Stream);
+    void Check_Waveform_Streams();
+    void Page_Changed(uint8_t Page_ID);
+    bool Transparent_Transfer(uint8_t Component_ID, uint8_t Channel, const uint8_t *Data, uint32_t Quantity);
+
+    template <typename Type>
+    void Add_Decimated_Value_Waveform(uint8_t Component_ID, uint8_t Channel, const Type *Data, uint32_t Quantity, uint16_t Width, Type Minimum, Type Maximum);
+
+    // -- Response correlator
+
+    enum Waiter_States
+    {
+        Waiter_Free,
+        Waiter_Claimed,
+        Waiter_Armed,
+        Waiter_Received
+    };
+
+    // -- Protocol trace
+
+    enum Trace_Directions
+    {
+        Trace_Transmit = 0,
+        Trace_Receive = 1
+    };
+
+#if Nextion_Trace_Size > 0
+    typedef struct
+    {
+        uint32_t Time; // -- In microseconds.
+        uint16_t Size; // -- Size of the frame, which may be greater than the recorded part.
+        uint8_t Direction;
+        uint8_t Data[Nextion_Trace_Frame_Size];
+    } Trace_Record_Type;
+
+    ///
+    /// @brief Reserve the next trace record (overwriting the oldest one) and fill its header. The caller copies the frame.
+    ///
+    inline Trace_Record_Type &Reserve_Trace_Record(uint8_t Direction, size_t Size)
+    {
+        Trace_Record_Type &Record = Trace_Records[__atomic_fetch_add(&Trace_Head, 1, __ATOMIC_RELAXED) % Nextion_Trace_Size];
+        Record.Time = micros();
+        Record.Size = (Size > 0xFFFF) ? 0xFFFF : Size;
+        Record.Direction = Direction;
+        return Record;
+    }
+#endif
 
-        State = false;
-        this->Expected_Event = 0xFF;
+    // -- Statistics
 
-        return true;
+#if Nextion_Statistics
+    ///
+    /// @brief Count a latency in a log2 bucketed histogram.
+    ///
+    static inline void Record_Latency(uint32_t *Histogram, uint32_t Latency)
+    {
+        uint8_t Bucket = (Latency == 0) ? 0 : 32 - __builtin_clz(Latency);
+        Histogram[(Bucket < Nextion_Statistics_Histogram_Size) ? Bucket : (Nextion_Statistics_Histogram_Size - 1)]++;
     }
+#endif
+
+    uint8_t Register_Waiter(uint8_t Expected_Event);
+    bool Wait_For_Event(uint8_t Waiter, uint32_t Time_Out = 500);
+    void Notify_Waiters(uint8_t Event);
 
     // -- Attributes
 
-    volatile uint8_t Expected_Event = 0xFF;
-    volatile bool State = false;
+    typedef struct
+    {
+        volatile uint8_t State;
+        volatile uint8_t Expected_Event;
+        volatile TaskHandle_t Task;
+#if Nextion_Statistics
+        uint32_t Start_Time;
+#endif
+    } Waiter_Type;
+
+    Waiter_Type Waiters[Nextion_Maximum_Waiters];
 
     static Nextion_Class *Instance_Pointer;
 
+    static void Transmit_Task(void *Instance);
+
+    // -- Header of a queued frame : the acknowledged instructions it holds.
+    typedef struct
+    {
+        uint32_t First_Command;
+        uint32_t Commands;
+    } Queued_Frame_Header_Type;
+
+    void Drop_Frame(Queued_Frame_Header_Type const &Header);
+
+    RingbufHandle_t Transmit_Ring_Buffer;
+    TaskHandle_t Transmit_Task_Handle;
+    volatile TaskHandle_t Flush_Task_Handle;
+    volatile uint32_t Pending_Frames;
+    Queue_Policies Transmit_Policy;
+    size_t Transmit_Queue_Size;
+    UBaseType_t Transmit_Priority;
+    uint32_t Transmit_Stack_Size;
+    uint32_t Flushed_Command; // -- Last acknowledged instruction written or queued.
+
+    TaskHandle_t Receive_Task_Handle;
+    SemaphoreHandle_t Receive_Semaphore;
+
     uint8_t Page_History[5];
 
     uint32_t Baud_Rate;
+    Nextion_Transport_Class *Transport;
+#ifdef ARDUINO
     HardwareSerial Nextion_Serial;
+    Nextion_Hardware_Serial_Transport_Class Serial_Transport;
+#endif
     SemaphoreHandle_t Serial_Semaphore;
     uint16_t Address;
 
@@ -337,8 +786,467 @@ protected:
 
     File Temporary_File;
 
+    Update_Statistics_Type Update_Statistics;
+#if Nextion_Trace_Size > 0
+    Trace_Record_Type Trace_Records[Nextion_Trace_Size];
+    uint32_t Trace_Head; // -- Number of records written since the last clear.
+#endif
+
+#if Nextion_Statistics
+    Statistics_Type Statistics;
+    uint32_t Receive_Overflows_Origin; // -- Transport overflow count at the last reset.
+#endif
+    void (*Callback_Function_Update_Progress)(uint32_t, uint32_t, uint32_t);
+
+    uint8_t Frame_Buffer[Nextion_Frame_Buffer_Size];
+    uint16_t Frame_Size;
+    bool Frame_Chunked;
+    uint8_t Frame_Type;
+    uint16_t Instruction_Offset; // -- Start of the current instruction in the frame buffer.
+
+    TaskHandle_t Batch_Task; // -- Task filling a batch, NULL outside of a batch.
+    uint8_t Batch_Depth;
+    bool Batch_Refresh;
+
+    SemaphoreHandle_t Window_Semaphore;
+    uint8_t Debugging_Level; // -- Restored when acknowledged mode is disabled.
+    uint32_t Command_Counter;
+    uint32_t Last_Command;
+    uint32_t Command_FIFO[Nextion_Maximum_Window];
+    uint8_t Command_Type[Nextion_Maximum_Window];
+    bool Command_Unsent[Nextion_Maximum_Window]; // -- Its frame was dropped from the transmit queue.
+    uint32_t Command_Cache_Key[Nextion_Maximum_Window]; // -- Shadow cache entry evicted if the instruction fails, 0 for none.
+#if Nextion_Statistics
+    uint32_t Command_Time[Nextion_Maximum_Window];
+#endif
+    volatile uint8_t Command_Head, Command_Tail;
+
+    typedef struct
+    {
+        uint32_t Command;
+        uint8_t Status;
+    } Command_History_Type;
+
+    Command_History_Type Command_History[Nextion_Command_History_Size];
+
+    void (*Callback_Function_Acknowledge)(uint32_t, uint8_t);
+
+    typedef struct
+    {
+        uint32_t Key; // -- FNV-1a hash of the attribute, 0 for a free entry.
+        uint32_t Last_Use;
+        uint8_t Key_Size;
+        uint8_t Size;
+        uint8_t Instruction[Nextion_Shadow_Cache_Entry_Size]; // -- Attribute and value, as last sent.
+    } Shadow_Entry_Type;
+
+    void Evict_Shadow_Entry(uint32_t Key);
+
+    Shadow_Entry_Type *Shadow_Cache;
+    uint8_t Shadow_Cache_Size;
+    uint32_t Shadow_Cache_Clock;
+    volatile bool Shadow_Cache_Invalidated;
+
     char Temporary_String[150];
     uint8_t Return_Code;
+
+    // -- Received bytes not parsed yet (the parser stops after each frame with a callback).
+    uint8_t Receive_Buffer[64];
+    uint8_t Receive_Position;
+    uint8_t Receive_Size;
+
+    // -- Callbacks of the parsed frames, called once the receive semaphore is released (so that they can send instructions).
+    typedef struct
+    {
+        uint8_t Type;
+        uint8_t Status; // -- Of the acknowledged instruction.
+        uint8_t Size;   // -- Of the string data.
+        uint32_t Value; // -- Numeric data, event or acknowledged instruction.
+        char String[sizeof(Temporary_String)];
+    } Callback_Type;
+
+    Callback_Type Callbacks[Nextion_Callback_Queue_Size];
+    uint8_t Callback_Tail;
+    uint8_t Callback_Count;
+    volatile TaskHandle_t Callback_Task; // -- Task calling a callback, NULL otherwise.
+
+    uint8_t Parser_State;
+    uint8_t Parser_Expected_Size;
+    uint8_t Parser_Size;
+    uint8_t Parser_Terminator_Count;
+
+    uint16_t Loop_Maximum_Bytes;
+    uint32_t Loop_Maximum_Time;
+
+    Waveform_Stream_Type Waveform_Streams[Nextion_Maximum_Waveform_Streams];
+};
+
+///
+/// @brief Batch scope : the instructions issued during its lifetime are sent in a single write when it is destroyed.
+///     {
+///         Nextion_Batch_Class Batch(Display, true);
+///         Display.Set_Value(Speed, 42);
+///         Display.Set_Text(Status, "Running");
+///     } // -- ref_stop, n0.val=42, t0.txt="Running", ref_star
+///
+class Nextion_Batch_Class
+{
+public:
+    Nextion_Batch_Class(Nextion_Class &Nextion, bool Freeze_Refresh = false) : Nextion(Nextion)
+    {
+        Nextion.Begin_Batch(Freeze_Refresh);
+    }
+
+    ~Nextion_Batch_Class()
+    {
+        Nextion.Commit_Batch();
+    }
+
+protected:
+    Nextion_Class &Nextion;
 };
 
-#endif
\ No newline at end of file
+// -- Adapters : every instruction is implemented once, for a null terminated object name and a sized text.
+
+inline void Nextion_Class::Set_Font(const __FlashStringHelper *Object_Name, uint8_t Font_ID)
+{
+    Set_Font(reinterpret_cast<const char *>(Object_Name), Font_ID);
+}
+
+inline void Nextion_Class::Set_Background_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type)
+{
+    Set_Background_Color(reinterpret_cast<const char *>(Object_Name), Color, Type);
+}
+
+inline void Nextion_Class::Set_Font_Color(const __FlashStringHelper *Object_Name, uint16_t Color, int8_t Type)
+{
+    Set_Font_Color(reinterpret_cast<const char *>(Object_Name), Color, Type);
+}
+
+inline void Nextion_Class::Set_Horizontal_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment)
+{
+    Set_Horizontal_Alignment(reinterpret_cast<const char *>(Object_Name), Alignment);
+}
+
+inline void Nextion_Class::Set_Vertical_Alignment(const __FlashStringHelper *Object_Name, uint8_t Alignment)
+{
+    Set_Vertical_Alignment(reinterpret_cast<const char *>(Object_Name), Alignment);
+}
+
+inline void Nextion_Class::Set_Mask(const __FlashStringHelper *Object_Name, bool Masked)
+{
+    Set_Mask(reinterpret_cast<const char *>(Object_Name), Masked);
+}
+
+inline void Nextion_Class::Set_Wordwrap(const __FlashStringHelper *Object_Name, bool Wordwrap)
+{
+    Set_Wordwrap(reinterpret_cast<const char *>(Object_Name), Wordwrap);
+}
+
+inline void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, const char *Value)
+{
+    Set_Text(reinterpret_cast<const char *>(Object_Name), Value);
+}
+
+inline void Nextion_Class::Add_Text(const __FlashStringHelper *Object_Name, const char *Data)
+{
+    Add_Text(reinterpret_cast<const char *>(Object_Name), Data);
+}
+
+inline void Nextion_Class::Delete_Text(const __FlashStringHelper *Object_Name, uint8_t Quantity)
+{
+    Delete_Text(reinterpret_cast<const char *>(Object_Name), Quantity);
+}
+
+inline void Nextion_Class::Set_Maximum_Value(const __FlashStringHelper *Object_Name, uint16_t Value)
+{
+    Set_Maximum_Value(reinterpret_cast<const char *>(Object_Name), Value);
+}
+
+inline void Nextion_Class::Set_Minimum_Value(const __FlashStringHelper *Object_Name, uint16_t Value)
+{
+    Set_Minimum_Value(reinterpret_cast<const char *>(Object_Name), Value);
+}
+
+inline void Nextion_Class::Set_Value(const __FlashStringHelper *Object_Name, uint32_t Value)
+{
+    Set_Value(reinterpret_cast<const char *>(Object_Name), Value);
+}
+
+inline void Nextion_Class::Set_Global_Variable(const __FlashStringHelper *Object_Name, uint32_t Value)
+{
+    Set_Global_Variable(reinterpret_cast<const char *>(Object_Name), Value);
+}
+
+inline void Nextion_Class::Set_Channel_Color(const __FlashStringHelper *Object_Name, uint8_t Channel_ID, uint16_t Color)
+{
+    Set_Channel_Color(reinterpret_cast<const char *>(Object_Name), Channel_ID, Color);
+}
+
+inline void Nextion_Class::Set_Grid_Color(const __FlashStringHelper *Object_Name, uint16_t Color)
+{
+    Set_Grid_Color(reinterpret_cast<const char *>(Object_Name), Color);
+}
+
+inline void Nextion_Class::Set_Grid_Width(const __FlashStringHelper *Object_Name, uint16_t Width)
+{
+    Set_Grid_Width(reinterpret_cast<const char *>(Object_Name), Width);
+}
+
+inline void Nextion_Class::Set_Grid_Height(const __FlashStringHelper *Object_Name, uint16_t Height)
+{
+    Set_Grid_Height(reinterpret_cast<const char *>(Object_Name), Height);
+}
+
+inline void Nextion_Class::Set_Data_Scaling(const __FlashStringHelper *Object_Name, uint16_t Scale)
+{
+    Set_Data_Scaling(reinterpret_cast<const char *>(Object_Name), Scale);
+}
+
+inline void Nextion_Class::Set_Picture(const __FlashStringHelper *Object_Name, uint8_t Picture_ID)
+{
+    Set_Picture(reinterpret_cast<const char *>(Object_Name), Picture_ID);
+}
+
+inline void Nextion_Class::Set_Time(const __FlashStringHelper *Object_Name, uint16_t Time)
+{
+    Set_Time(reinterpret_cast<const char *>(Object_Name), Time);
+}
+
+inline void Nextion_Class::Set_Trigger(const __FlashStringHelper *Object_Name, bool Enable)
+{
+    Set_Trigger(reinterpret_cast<const char *>(Object_Name), Enable);
+}
+
+inline void Nextion_Class::Send_Raw(const __FlashStringHelper *Data)
+{
+    Send_Raw(reinterpret_cast<const char *>(Data));
+}
+
+inline void Nextion_Class::Refresh(const __FlashStringHelper *Object_Name)
+{
+    Refresh(reinterpret_cast<const char *>(Object_Name));
+}
+
+inline void Nextion_Class::Click(const __FlashStringHelper *Object_Name, uint8_t Event_Type)
+{
+    Click(reinterpret_cast<const char *>(Object_Name), Event_Type);
+}
+
+inline void Nextion_Class::Get(const __FlashStringHelper *Attribute)
+{
+    Get(reinterpret_cast<const char *>(Attribute));
+}
+
+inline void Nextion_Class::Show(const __FlashStringHelper *Object_Name)
+{
+    Show(reinterpret_cast<const char *>(Object_Name));
+}
+
+inline void Nextion_Class::Hide(const __FlashStringHelper *Object_Name)
+{
+    Hide(reinterpret_cast<const char *>(Object_Name));
+}
+
+inline void Nextion_Class::Set_Touch_Event(const __FlashStringHelper *Object_Name, bool Enable)
+{
+    Set_Touch_Event(reinterpret_cast<const char *>(Object_Name), Enable);
+}
+
+inline void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, char Value)
+{
+    char Temporary_Value[2] = {Value, '\0'};
+    Set_Text(reinterpret_cast<const char *>(Object_Name), Temporary_Value);
+}
+
+inline void Nextion_Class::Set_Text(const __FlashStringHelper *Object_Name, const __FlashStringHelper *Value)
+{
+    Set_Text(reinterpret_cast<const char *>(Object_Name), reinterpret_cast<const char *>(Value));
+}
+
+inline void Nextion_Class::Add_Text(const __FlashStringHelper *Object_Name, char Data)
+{
+    char Temporary_Data[2] = {Data, '\0'};
+    Add_Text(reinterpret_cast<const char *>(Object_Name), Temporary_Data);
+}
+
+inline void Nextion_Class::Set_Text(const char *Object_Name, const char *Value)
+{
+    Set_Text(Object_Name, Value, strlen(Value));
+}
+
+inline void Nextion_Class::Add_Text(const char *Object_Name, const char *Data)
+{
+    Add_Text(Object_Name, Data, strlen(Data));
+}
+
+inline void Nextion_Class::Send_Raw(const char *Data)
+{
+    Send_Raw(Data, strlen(Data));
+}
+
+inline void Nextion_Class::Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, const char *Text)
+{
+    Draw_Text(X_Coordinate, Y_Coordinate, Width, Height, Font_ID, Text_Color, Background, Horizontal_Alignment, Vertical_Alignment, Background_Type, Text, strlen(Text));
+}
+
+#if Nextion_String_Overloads
+
+inline void Nextion_Class::Set_Font(String const &Object_Name, uint8_t Font_ID)
+{
+    Set_Font(Object_Name.c_str(), Font_ID);
+}
+
+inline void Nextion_Class::Set_Background_Color(String const &Object_Name, uint16_t Color, int8_t Type)
+{
+    Set_Background_Color(Object_Name.c_str(), Color, Type);
+}
+
+inline void Nextion_Class::Set_Font_Color(String const &Object_Name, uint16_t Color, int8_t Type)
+{
+    Set_Font_Color(Object_Name.c_str(), Color, Type);
+}
+
+inline void Nextion_Class::Set_Horizontal_Alignment(String const &Object_Name, uint8_t Alignment)
+{
+    Set_Horizontal_Alignment(Object_Name.c_str(), Alignment);
+}
+
+inline void Nextion_Class::Set_Vertical_Alignment(String const &Object_Name, uint8_t Alignment)
+{
+    Set_Vertical_Alignment(Object_Name.c_str(), Alignment);
+}
+
+inline void Nextion_Class::Set_Mask(String const &Object_Name, bool Masked)
+{
+    Set_Mask(Object_Name.c_str(), Masked);
+}
+
+inline void Nextion_Class::Set_Wordwrap(String const &Object_Name, bool Wordwrap)
+{
+    Set_Wordwrap(Object_Name.c_str(), Wordwrap);
+}
+
+inline void Nextion_Class::Set_Text(String const &Object_Name, const char *Value)
+{
+    Set_Text(Object_Name.c_str(), Value);
+}
+
+inline void Nextion_Class::Add_Text(String const &Object_Name, const char *Data)
+{
+    Add_Text(Object_Name.c_str(), Data);
+}
+
+inline void Nextion_Class::Delete_Text(String const &Object_Name, uint8_t Quantity)
+{
+    Delete_Text(Object_Name.c_str(), Quantity);
+}
+
+inline void Nextion_Class::Set_Maximum_Value(String const &Object_Name, uint16_t Value)
+{
+    Set_Maximum_Value(Object_Name.c_str(), Value);
+}
+
+inline void Nextion_Class::Set_Minimum_Value(String const &Object_Name, uint16_t Value)
+{
+    Set_Minimum_Value(Object_Name.c_str(), Value);
+}
+
+inline void Nextion_Class::Set_Value(String const &Object_Name, uint32_t Value)
+{
+    Set_Value(Object_Name.c_str(), Value);
+}
+
+inline void Nextion_Class::Set_Global_Variable(String const &Object_Name, uint32_t Value)
+{
+    Set_Global_Variable(Object_Name.c_str(), Value);
+}
+
+inline void Nextion_Class::Set_Channel_Color(String const &Object_Name, uint8_t Channel_ID, uint16_t Color)
+{
+    Set_Channel_Color(Object_Name.c_str(), Channel_ID, Color);
+}
+
+inline void Nextion_Class::Set_Grid_Color(String const &Object_Name, uint16_t Color)
+{
+    Set_Grid_Color(Object_Name.c_str(), Color);
+}
+
+inline void Nextion_Class::Set_Grid_Width(String const &Object_Name, uint16_t Width)
+{
+    Set_Grid_Width(Object_Name.c_str(), Width);
+}
+
+inline void Nextion_Class::Set_Grid_Height(String const &Object_Name, uint16_t Height)
+{
+    Set_Grid_Height(Object_Name.c_str(), Height);
+}
+
+inline void Nextion_Class::Set_Data_Scaling(String const &Object_Name, uint16_t Scale)
+{
+    Set_Data_Scaling(Object_Name.c_str(), Scale);
+}
+
+inline void Nextion_Class::Set_Picture(String const &Object_Name, uint8_t Picture_ID)
+{
+    Set_Picture(Object_Name.c_str(), Picture_ID);
+}
+
+inline void Nextion_Class::Set_Time(String const &Object_Name, uint16_t Time)
+{
+    Set_Time(Object_Name.c_str(), Time);
+}
+
+inline void Nextion_Class::Set_Trigger(String const &Object_Name, bool Enable)
+{
+    Set_Trigger(Object_Name.c_str(), Enable);
+}
+
+inline void Nextion_Class::Send_Raw(String const &Data)
+{
+    Send_Raw(Data.c_str(), Data.length());
+}
+
+inline void Nextion_Class::Refresh(String const &Object_Name)
+{
+    Refresh(Object_Name.c_str());
+}
+
+inline void Nextion_Class::Click(String const &Object_Name, uint8_t Event_Type)
+{
+    Click(Object_Name.c_str(), Event_Type);
+}
+
+inline void Nextion_Class::Get(String const &Attribute)
+{
+    Get(Attribute.c_str());
+}
+
+inline void Nextion_Class::Show(String const &Object_Name)
+{
+    Show(Object_Name.c_str());
+}
+
+inline void Nextion_Class::Hide(String const &Object_Name)
+{
+    Hide(Object_Name.c_str());
+}
+
+inline void Nextion_Class::Set_Touch_Event(String const &Object_Name, bool Enable)
+{
+    Set_Touch_Event(Object_Name.c_str(), Enable);
+}
+
+inline void Nextion_Class::Set_Text(String const &Object_Name, String const &Value)
+{
+    Set_Text(Object_Name.c_str(), Value.c_str(), Value.length());
+}
+
+inline void Nextion_Class::Draw_Text(uint16_t X_Coordinate, uint16_t Y_Coordinate, uint16_t Width, uint16_t Height, uint16_t Font_ID, uint16_t Text_Color, uint16_t Background, uint16_t Horizontal_Alignment, uint16_t Vertical_Alignment, uint16_t Background_Type, String const &Text)
+{
+    Draw_Text(X_Coordinate, Y_Coordinate, Width, Height, Font_ID, Text_Color, Background, Horizontal_Alignment, Vertical_Alignment, Background_Type, Text.c_str(), Text.length());
+}
+
+#endif
+
+#endif
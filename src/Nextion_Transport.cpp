@@ -0,0 +1,446 @@
+///
+/// @file Nextion_Transport.cpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Byte stream transports source file.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#include "Nextion_Transport.hpp"
+
+// -- Recording
+
+///
+/// @brief Create a recording transport. The capture header is written immediately.
+///
+/// @param Transport Transport to forward to.
+/// @param Capture File opened for writing.
+Nextion_Recording_Transport_Class::Nextion_Recording_Transport_Class(Nextion_Transport_Class &Transport, File Capture) : Transport(Transport),
+                                                                                                                       Capture(Capture)
+{
+    const uint8_t Header[] = {'N', 'X', 'R', 'X', 1};
+    this->Capture.write(Header, sizeof(Header));
+}
+
+size_t Nextion_Recording_Transport_Class::Write(const uint8_t *Data, size_t Size)
+{
+    return Transport.Write(Data, Size);
+}
+
+size_t Nextion_Recording_Transport_Class::Available()
+{
+    return Transport.Available();
+}
+
+size_t Nextion_Recording_Transport_Class::Read(uint8_t *Data, size_t Size)
+{
+    if (Size > 0xFFFF)
+    {
+        Size = 0xFFFF;
+    }
+    Size = Transport.Read(Data, Size);
+    if (Size > 0)
+    {
+        uint32_t Time = micros();
+        const uint8_t Header[] = {(uint8_t)Time, (uint8_t)(Time >> 8), (uint8_t)(Time >> 16), (uint8_t)(Time >> 24), (uint8_t)Size, (uint8_t)(Size >> 8)};
+        Capture.write(Header, sizeof(Header));
+        Capture.write(Data, Size);
+    }
+    return Size;
+}
+
+bool Nextion_Recording_Transport_Class::Set_Baud_Rate(uint32_t Baud_Rate)
+{
+    return Transport.Set_Baud_Rate(Baud_Rate);
+}
+
+bool Nextion_Recording_Transport_Class::Wait_For_Data(uint32_t Time_Out)
+{
+    return Transport.Wait_For_Data(Time_Out);
+}
+
+void Nextion_Recording_Transport_Class::Flush()
+{
+    Transport.Flush();
+}
+
+uint32_t Nextion_Recording_Transport_Class::Get_Overflows()
+{
+    return Transport.Get_Overflows();
+}
+
+#ifdef ARDUINO
+
+// -- Event group bit set when data is received.
+static const EventBits_t Data_Received_Bit = (1 << 0);
+
+///
+/// @brief Wait for the data received bit of an event group, without missing data received in the meantime.
+///
+static bool Wait_For_Data_Received_Bit(Nextion_Transport_Class &Transport, EventGroupHandle_t Event_Group, uint32_t Time_Out)
+{
+    if (Transport.Available() > 0)
+    {
+        return true;
+    }
+    xEventGroupClearBits(Event_Group, Data_Received_Bit);
+    if (Transport.Available() > 0) // -- Received before the bit was cleared.
+    {
+        return true;
+    }
+    xEventGroupWaitBits(Event_Group, Data_Received_Bit, pdFALSE, pdTRUE, (Time_Out == portMAX_DELAY) ? portMAX_DELAY : pdMS_TO_TICKS(Time_Out));
+    return Transport.Available() > 0;
+}
+
+// -- Hardware serial
+
+Nextion_Hardware_Serial_Transport_Class::Nextion_Hardware_Serial_Transport_Class(HardwareSerial &Port) : Port(Port),
+                                                                                                        Event_Group(xEventGroupCreate()),
+                                                                                                        Overflows(0)
+{
+}
+
+Nextion_Hardware_Serial_Transport_Class::~Nextion_Hardware_Serial_Transport_Class()
+{
+    Port.onReceive(NULL);
+    Port.onReceiveError(NULL);
+    vEventGroupDelete(Event_Group);
+}
+
+///
+/// @brief Start the UART, and wake up the tasks waiting for data as soon as it is received.
+/// @details The transmit buffer holds Nextion_UART_Transmit_Buffer_Size bytes, so that writes return immediately.
+///
+/// @param Baud_Rate Baud rate.
+/// @param RX_Pin UART RX pin.
+/// @param TX_Pin UART TX pin.
+/// @return true if the UART has been started, false otherwise.
+bool Nextion_Hardware_Serial_Transport_Class::Begin(uint32_t Baud_Rate, int8_t RX_Pin, int8_t TX_Pin)
+{
+    if (Event_Group == NULL)
+    {
+        return false;
+    }
+    Port.setTxBufferSize(Nextion_UART_Transmit_Buffer_Size); // -- Must be set before the driver is installed.
+    Port.begin(Baud_Rate, SERIAL_8N1, RX_Pin, TX_Pin);
+    EventGroupHandle_t Event_Group = this->Event_Group;
+    Port.onReceive([Event_Group]()
+                   { xEventGroupSetBits(Event_Group, Data_Received_Bit); });
+    volatile uint32_t *Overflows = &this->Overflows;
+    Port.onReceiveError([Overflows](hardwareSerial_error_t Error)
+                        {
+                            if (Error == UART_BUFFER_FULL_ERROR || Error == UART_FIFO_OVF_ERROR)
+                            {
+                                (*Overflows)++;
+                            } });
+    return true;
+}
+
+size_t Nextion_Hardware_Serial_Transport_Class::Write(const uint8_t *Data, size_t Size)
+{
+    return Port.write(Data, Size);
+}
+
+size_t Nextion_Hardware_Serial_Transport_Class::Available()
+{
+    int Available = Port.available();
+    return (Available > 0) ? Available : 0;
+}
+
+size_t Nextion_Hardware_Serial_Transport_Class::Read(uint8_t *Data, size_t Size)
+{
+    return Port.read(Data, Size);
+}
+
+bool Nextion_Hardware_Serial_Transport_Class::Set_Baud_Rate(uint32_t Baud_Rate)
+{
+    Port.updateBaudRate(Baud_Rate);
+    return true;
+}
+
+bool Nextion_Hardware_Serial_Transport_Class::Wait_For_Data(uint32_t Time_Out)
+{
+    return Wait_For_Data_Received_Bit(*this, Event_Group, Time_Out);
+}
+
+void Nextion_Hardware_Serial_Transport_Class::Flush()
+{
+    Port.flush();
+}
+
+uint32_t Nextion_Hardware_Serial_Transport_Class::Get_Overflows()
+{
+    return Overflows;
+}
+
+// -- USB CDC
+
+#if CONFIG_TINYUSB_CDC_ENABLED
+
+Nextion_USB_CDC_Transport_Class *Nextion_USB_CDC_Transport_Class::Instance_Pointer = NULL;
+
+Nextion_USB_CDC_Transport_Class::Nextion_USB_CDC_Transport_Class(USBCDC &Port) : Port(Port),
+                                                                                Event_Group(xEventGroupCreate()),
+                                                                                Overflows(0)
+{
+    Instance_Pointer = this;
+}
+
+Nextion_USB_CDC_Transport_Class::~Nextion_USB_CDC_Transport_Class()
+{
+    if (Instance_Pointer == this)
+    {
+        Instance_Pointer = NULL;
+    }
+    vEventGroupDelete(Event_Group);
+}
+
+///
+/// @brief Start the USB CDC port, and wake up the tasks waiting for data as soon as it is received.
+///
+/// @return true if the port has been started, false otherwise.
+bool Nextion_USB_CDC_Transport_Class::Begin()
+{
+    if (Event_Group == NULL)
+    {
+        return false;
+    }
+    Port.onEvent(ARDUINO_USB_CDC_RX_EVENT, Event_Handler);
+    Port.onEvent(ARDUINO_USB_CDC_RX_OVERFLOW_EVENT, Event_Handler);
+    Port.begin();
+    return true;
+}
+
+void Nextion_USB_CDC_Transport_Class::Event_Handler(void *Argument, esp_event_base_t Event_Base, int32_t Event_ID, void *Event_Data)
+{
+    // -- The handler argument is the USBCDC instance : the transport is found through its instance pointer.
+    if (Instance_Pointer == NULL)
+    {
+        return;
+    }
+    if (Event_ID == ARDUINO_USB_CDC_RX_OVERFLOW_EVENT)
+    {
+        Instance_Pointer->Overflows++;
+    }
+    else
+    {
+        xEventGroupSetBits(Instance_Pointer->Event_Group, Data_Received_Bit);
+    }
+}
+
+size_t Nextion_USB_CDC_Transport_Class::Write(const uint8_t *Data, size_t Size)
+{
+    return Port.write(Data, Size);
+}
+
+size_t Nextion_USB_CDC_Transport_Class::Available()
+{
+    int Available = Port.available();
+    return (Available > 0) ? Available : 0;
+}
+
+size_t Nextion_USB_CDC_Transport_Class::Read(uint8_t *Data, size_t Size)
+{
+    return Port.read(Data, Size);
+}
+
+bool Nextion_USB_CDC_Transport_Class::Set_Baud_Rate(uint32_t Baud_Rate)
+{
+    return true; // -- The line coding is set by the USB host.
+}
+
+bool Nextion_USB_CDC_Transport_Class::Wait_For_Data(uint32_t Time_Out)
+{
+    return Wait_For_Data_Received_Bit(*this, Event_Group, Time_Out);
+}
+
+void Nextion_USB_CDC_Transport_Class::Flush()
+{
+    Port.flush();
+}
+
+uint32_t Nextion_USB_CDC_Transport_Class::Get_Overflows()
+{
+    return Overflows;
+}
+
+#endif
+
+#else
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+// -- POSIX terminal
+
+Nextion_POSIX_Transport_Class::Nextion_POSIX_Transport_Class() : File_Descriptor(-1),
+                                                                 Owned(false)
+{
+}
+
+Nextion_POSIX_Transport_Class::~Nextion_POSIX_Transport_Class()
+{
+    Close();
+}
+
+///
+/// @brief Open a terminal (serial adapter or pseudo terminal) in raw mode.
+///
+/// @param Path Path of the terminal.
+/// @param Baud_Rate Baud rate.
+/// @return true if the terminal has been opened, false otherwise.
+bool Nextion_POSIX_Transport_Class::Open(const char *Path, uint32_t Baud_Rate)
+{
+    Close();
+
+    File_Descriptor = open(Path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (File_Descriptor < 0)
+    {
+        return false;
+    }
+    Owned = true;
+
+    struct termios Attributes;
+    if (tcgetattr(File_Descriptor, &Attributes) != 0)
+    {
+        Close();
+        return false;
+    }
+    cfmakeraw(&Attributes);
+    Attributes.c_cflag |= CLOCAL | CREAD;
+    Attributes.c_cc[VMIN] = 0;
+    Attributes.c_cc[VTIME] = 0;
+    if (tcsetattr(File_Descriptor, TCSANOW, &Attributes) != 0 || !Set_Baud_Rate(Baud_Rate))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+///
+/// @brief Use an already opened file descriptor (pseudo terminal master, socket, pipe ...). It is not closed by the transport.
+///
+/// @return true if the file descriptor can be used, false otherwise.
+bool Nextion_POSIX_Transport_Class::Open(int File_Descriptor)
+{
+    Close();
+
+    int Flags = fcntl(File_Descriptor, F_GETFL);
+    if (Flags < 0 || fcntl(File_Descriptor, F_SETFL, Flags | O_NONBLOCK) < 0)
+    {
+        return false;
+    }
+    this->File_Descriptor = File_Descriptor;
+    Owned = false;
+    return true;
+}
+
+void Nextion_POSIX_Transport_Class::Close()
+{
+    if (Owned && File_Descriptor >= 0)
+    {
+        close(File_Descriptor);
+    }
+    File_Descriptor = -1;
+    Owned = false;
+}
+
+size_t Nextion_POSIX_Transport_Class::Write(const uint8_t *Data, size_t Size)
+{
+    size_t Written = 0;
+    while (Written < Size)
+    {
+        ssize_t Result = write(File_Descriptor, Data + Written, Size - Written);
+        if (Result > 0)
+        {
+            Written += Result;
+        }
+        else if (Result < 0 && errno == EAGAIN)
+        {
+            struct pollfd Poll = {File_Descriptor, POLLOUT, 0};
+            poll(&Poll, 1, -1);
+        }
+        else if (Result < 0 && errno != EINTR)
+        {
+            break;
+        }
+    }
+    return Written;
+}
+
+size_t Nextion_POSIX_Transport_Class::Available()
+{
+    int Available = 0;
+    if (ioctl(File_Descriptor, FIONREAD, &Available) != 0 || Available < 0)
+    {
+        return 0;
+    }
+    return Available;
+}
+
+size_t Nextion_POSIX_Transport_Class::Read(uint8_t *Data, size_t Size)
+{
+    ssize_t Result = read(File_Descriptor, Data, Size);
+    return (Result > 0) ? Result : 0;
+}
+
+bool Nextion_POSIX_Transport_Class::Set_Baud_Rate(uint32_t Baud_Rate)
+{
+    struct termios Attributes;
+    if (tcgetattr(File_Descriptor, &Attributes) != 0)
+    {
+        return true; // -- Not a terminal : the baud rate is meaningless.
+    }
+
+    const struct
+    {
+        uint32_t Baud_Rate;
+        speed_t Speed;
+    } Speeds[] = {
+        {2400, B2400},
+        {4800, B4800},
+        {9600, B9600},
+        {19200, B19200},
+        {38400, B38400},
+        {57600, B57600},
+        {115200, B115200},
+        {230400, B230400},
+#ifdef B921600
+        {921600, B921600},
+#endif
+    };
+
+    for (uint8_t i = 0; i < sizeof(Speeds) / sizeof(Speeds[0]); i++)
+    {
+        if (Speeds[i].Baud_Rate == Baud_Rate)
+        {
+            cfsetispeed(&Attributes, Speeds[i].Speed);
+            cfsetospeed(&Attributes, Speeds[i].Speed);
+            return tcsetattr(File_Descriptor, TCSANOW, &Attributes) == 0;
+        }
+    }
+    return false;
+}
+
+bool Nextion_POSIX_Transport_Class::Wait_For_Data(uint32_t Time_Out)
+{
+    struct pollfd Poll = {File_Descriptor, POLLIN, 0};
+    int Result;
+    do
+    {
+        Result = poll(&Poll, 1, (Time_Out == 0xFFFFFFFF) ? -1 : (int)Time_Out);
+    } while (Result < 0 && errno == EINTR);
+    return Result > 0 && (Poll.revents & POLLIN);
+}
+
+void Nextion_POSIX_Transport_Class::Flush()
+{
+    tcdrain(File_Descriptor);
+}
+
+#endif
@@ -0,0 +1,210 @@
+///
+/// @file Nextion_Transport.hpp
+/// @author Alix ANNERAUD (alix.anneraud@outlook.fr)
+/// @brief Byte stream transports used to communicate with the display.
+///
+/// @copyright Copyright (c) 2021
+///
+
+#ifndef NEXTION_TRANSPORT_H_INCLUDED
+#define NEXTION_TRANSPORT_H_INCLUDED
+
+#include "Arduino.h"
+#include "FS.h"
+
+#include "Configuration.hpp"
+
+#ifdef ARDUINO
+#include "HardwareSerial.h"
+#include "freertos/event_groups.h"
+#if CONFIG_TINYUSB_CDC_ENABLED
+#include "USBCDC.h"
+#endif
+#endif
+
+///
+/// @brief Byte stream between the library and the display.
+/// @details Implementations must allow Write() to be called from one task while another one reads, and Wait_For_Data() to be called from several tasks.
+///
+class Nextion_Transport_Class
+{
+public:
+    virtual ~Nextion_Transport_Class() {}
+
+    ///
+    /// @brief Write a frame.
+    ///
+    /// @return Number of bytes written.
+    virtual size_t Write(const uint8_t *Data, size_t Size) = 0;
+
+    ///
+    /// @brief Return the number of received bytes that can be read without blocking.
+    ///
+    virtual size_t Available() = 0;
+
+    ///
+    /// @brief Read received bytes, without blocking.
+    ///
+    /// @return Number of bytes read.
+    virtual size_t Read(uint8_t *Data, size_t Size) = 0;
+
+    ///
+    /// @brief Change the baud rate.
+    ///
+    /// @return true if the baud rate has been changed (or is meaningless for this transport), false otherwise.
+    virtual bool Set_Baud_Rate(uint32_t Baud_Rate) = 0;
+
+    ///
+    /// @brief Block the calling task until data is received.
+    ///
+    /// @param Time_Out Maximum time to wait (in milliseconds).
+    /// @return true if data is available, false on timeout.
+    virtual bool Wait_For_Data(uint32_t Time_Out) = 0;
+
+    ///
+    /// @brief Block the calling task until the written data has been sent.
+    ///
+    virtual void Flush() = 0;
+
+    ///
+    /// @brief Return the number of receive buffer overflows since the transport creation (0 if not detected).
+    ///
+    virtual uint32_t Get_Overflows()
+    {
+        return 0;
+    }
+
+    ///
+    /// @brief Read a single byte, without blocking.
+    ///
+    /// @return The byte, or -1 if none has been received.
+    inline int Read_Byte()
+    {
+        uint8_t Byte;
+        return (Read(&Byte, 1) == 1) ? Byte : -1;
+    }
+
+    ///
+    /// @brief Discard received data.
+    ///
+    inline void Clear()
+    {
+        uint8_t Buffer[32];
+        while (Available() > 0 && Read(Buffer, sizeof(Buffer)) > 0)
+        {
+        }
+    }
+};
+
+///
+/// @brief Transport forwarding to another one, and recording the received bytes in a capture file, to be replayed on the host (extras/Replay).
+/// @details Capture format (little endian) : "NXRX", version (1 byte), then one record per read : time in microseconds (4 bytes), size (2 bytes) and the received bytes.
+///
+class Nextion_Recording_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Nextion_Recording_Transport_Class(Nextion_Transport_Class &Transport, File Capture);
+
+    size_t Write(const uint8_t *Data, size_t Size);
+    size_t Available();
+    size_t Read(uint8_t *Data, size_t Size);
+    bool Set_Baud_Rate(uint32_t Baud_Rate);
+    bool Wait_For_Data(uint32_t Time_Out);
+    void Flush();
+    uint32_t Get_Overflows();
+
+protected:
+    Nextion_Transport_Class &Transport;
+    File Capture;
+};
+
+#ifdef ARDUINO
+
+///
+/// @brief Transport over an ESP32 UART.
+///
+class Nextion_Hardware_Serial_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Nextion_Hardware_Serial_Transport_Class(HardwareSerial &Port);
+    ~Nextion_Hardware_Serial_Transport_Class();
+
+    bool Begin(uint32_t Baud_Rate, int8_t RX_Pin, int8_t TX_Pin);
+
+    size_t Write(const uint8_t *Data, size_t Size);
+    size_t Available();
+    size_t Read(uint8_t *Data, size_t Size);
+    bool Set_Baud_Rate(uint32_t Baud_Rate);
+    bool Wait_For_Data(uint32_t Time_Out);
+    void Flush();
+    uint32_t Get_Overflows();
+
+protected:
+    HardwareSerial &Port;
+    EventGroupHandle_t Event_Group;
+    volatile uint32_t Overflows;
+};
+
+#if CONFIG_TINYUSB_CDC_ENABLED
+
+///
+/// @brief Transport over an USB CDC port (ESP32-S2 / S3), for displays bridged through USB. The baud rate is set by the host.
+///
+class Nextion_USB_CDC_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Nextion_USB_CDC_Transport_Class(USBCDC &Port);
+    ~Nextion_USB_CDC_Transport_Class();
+
+    bool Begin();
+
+    size_t Write(const uint8_t *Data, size_t Size);
+    size_t Available();
+    size_t Read(uint8_t *Data, size_t Size);
+    bool Set_Baud_Rate(uint32_t Baud_Rate);
+    bool Wait_For_Data(uint32_t Time_Out);
+    void Flush();
+    uint32_t Get_Overflows();
+
+protected:
+    static void Event_Handler(void *Argument, esp_event_base_t Event_Base, int32_t Event_ID, void *Event_Data);
+
+    static Nextion_USB_CDC_Transport_Class *Instance_Pointer;
+
+    USBCDC &Port;
+    EventGroupHandle_t Event_Group;
+    volatile uint32_t Overflows;
+};
+
+#endif
+
+#else
+
+///
+/// @brief Transport over a POSIX terminal (serial adapter or pseudo terminal), to run the library on a host.
+///
+class Nextion_POSIX_Transport_Class : public Nextion_Transport_Class
+{
+public:
+    Nextion_POSIX_Transport_Class();
+    ~Nextion_POSIX_Transport_Class();
+
+    bool Open(const char *Path, uint32_t Baud_Rate);
+    bool Open(int File_Descriptor);
+    void Close();
+
+    size_t Write(const uint8_t *Data, size_t Size);
+    size_t Available();
+    size_t Read(uint8_t *Data, size_t Size);
+    bool Set_Baud_Rate(uint32_t Baud_Rate);
+    bool Wait_For_Data(uint32_t Time_Out);
+    void Flush();
+
+protected:
+    int File_Descriptor;
+    bool Owned;
+};
+
+#endif
+
+#endif